@@ -0,0 +1,213 @@
+#ifndef EXPRESSION_HPP
+#define EXPRESSION_HPP
+#include <ostream>
+#include <bits/stdc++.h>
+
+#include "value.hpp"
+
+namespace PlexiStruct::Engine::expr {
+
+    /**
+     * Value together with its gradient against every one of the N inputs (forward mode)
+     */
+    template<typename T, std::size_t N>
+    struct Dual {
+        T value { 0 };
+        std::array<T, N> grad {};
+    };
+
+    template<typename E>
+    struct IsExpression: std::false_type {};
+
+    template<typename E>
+    concept Expression = IsExpression<std::remove_cvref_t<E>>::value;
+
+    /**
+     * Placeholder for input I of the formula
+     */
+    template<std::size_t I>
+    struct Variable {
+        template<typename T, std::size_t N>
+        constexpr auto eval(const std::array<T, N>& inputs) const -> T {
+            static_assert(I < N, "formula reads more inputs than were given");
+            return inputs[I];
+        }
+
+        template<typename T, std::size_t N>
+        constexpr auto eval_dual(const std::array<T, N>& inputs) const -> Dual<T, N> {
+            Dual<T, N> result { .value = eval(inputs) };
+            result.grad[I] = T{ 1 };
+            return result;
+        }
+
+        template<typename T, std::size_t N>
+        auto to_value(const std::array<ScalarValue<T>, N>& leaves) const -> ScalarValue<T> {
+            static_assert(I < N, "formula reads more inputs than were given");
+            return leaves[I];
+        }
+    };
+
+    template<typename V>
+    struct Constant {
+        V value;
+
+        template<typename T, std::size_t N>
+        constexpr auto eval(const std::array<T, N>&) const -> T {
+            return static_cast<T>(value);
+        }
+
+        template<typename T, std::size_t N>
+        constexpr auto eval_dual(const std::array<T, N>& inputs) const -> Dual<T, N> {
+            return {.value = eval(inputs)};
+        }
+
+        template<typename T, std::size_t N>
+        auto to_value(const std::array<ScalarValue<T>, N>&) const -> ScalarValue<T> {
+            return ScalarValue<T>(static_cast<T>(value));
+        }
+    };
+
+    /**
+     * Node of the compile time tree, the shape of the whole formula lives in the type
+     */
+    template<Operations Op, typename L, typename R>
+    struct Binary {
+        L lhs;
+        R rhs;
+
+        template<typename T, std::size_t N>
+        constexpr auto eval(const std::array<T, N>& inputs) const -> T {
+            const T a = lhs.eval(inputs);
+            const T b = rhs.eval(inputs);
+            if constexpr (Op == Operations::ADD) { return a + b; }
+            else if constexpr (Op == Operations::SUBTRACT) { return a - b; }
+            else if constexpr (Op == Operations::MULTIPLY) { return a * b; }
+            else { return a / b; }
+        }
+
+        template<typename T, std::size_t N>
+        constexpr auto eval_dual(const std::array<T, N>& inputs) const -> Dual<T, N> {
+            const Dual<T, N> a = lhs.eval_dual(inputs);
+            const Dual<T, N> b = rhs.eval_dual(inputs);
+            Dual<T, N> result;
+            for (std::size_t i = 0; i < N; ++i) {
+                if constexpr (Op == Operations::ADD) { result.grad[i] = a.grad[i] + b.grad[i]; }
+                else if constexpr (Op == Operations::SUBTRACT) { result.grad[i] = a.grad[i] - b.grad[i]; }
+                else if constexpr (Op == Operations::MULTIPLY) { result.grad[i] = a.grad[i] * b.value + a.value * b.grad[i]; }
+                else { result.grad[i] = (a.grad[i] * b.value - a.value * b.grad[i]) / (b.value * b.value); }
+            }
+            if constexpr (Op == Operations::ADD) { result.value = a.value + b.value; }
+            else if constexpr (Op == Operations::SUBTRACT) { result.value = a.value - b.value; }
+            else if constexpr (Op == Operations::MULTIPLY) { result.value = a.value * b.value; }
+            else { result.value = a.value / b.value; }
+            return result;
+        }
+
+        template<typename T, std::size_t N>
+        auto to_value(const std::array<ScalarValue<T>, N>& leaves) const -> ScalarValue<T> {
+            static_assert(Op == Operations::ADD || Op == Operations::SUBTRACT,
+                          "ScalarValue only records addition and subtraction");
+            ScalarValue<T> a = lhs.to_value(leaves);
+            const ScalarValue<T> b = rhs.to_value(leaves);
+            if constexpr (Op == Operations::ADD) { return a + b; }
+            else { return a - b; }
+        }
+    };
+
+    template<std::size_t I>
+    struct IsExpression<Variable<I>>: std::true_type {};
+
+    template<typename V>
+    struct IsExpression<Constant<V>>: std::true_type {};
+
+    template<Operations Op, typename L, typename R>
+    struct IsExpression<Binary<Op, L, R>>: std::true_type {};
+
+    template<std::size_t I>
+    constexpr auto var() -> Variable<I> { return {}; }
+
+    template<typename V>
+    constexpr auto constant(const V& value) -> Constant<V> { return {value}; }
+
+    namespace detail {
+        template<typename E>
+        constexpr auto lift(const E& value) {
+            if constexpr (Expression<E>) {
+                return value;
+            } else {
+                return constant(value);
+            }
+        }
+
+        template<typename L, typename R>
+        concept Operands = (Expression<L> || Expression<R>)
+                        && (Expression<L> || std::is_arithmetic_v<std::remove_cvref_t<L>>)
+                        && (Expression<R> || std::is_arithmetic_v<std::remove_cvref_t<R>>);
+
+        template<Operations Op, typename L, typename R>
+        constexpr auto make(const L& lhs, const R& rhs) {
+            using Lhs = decltype(lift(lhs));
+            using Rhs = decltype(lift(rhs));
+            return Binary<Op, Lhs, Rhs>{lift(lhs), lift(rhs)};
+        }
+    }
+
+    template<typename L, typename R> requires detail::Operands<L, R>
+    constexpr auto operator+(const L& lhs, const R& rhs) { return detail::make<Operations::ADD>(lhs, rhs); }
+
+    template<typename L, typename R> requires detail::Operands<L, R>
+    constexpr auto operator-(const L& lhs, const R& rhs) { return detail::make<Operations::SUBTRACT>(lhs, rhs); }
+
+    template<typename L, typename R> requires detail::Operands<L, R>
+    constexpr auto operator*(const L& lhs, const R& rhs) { return detail::make<Operations::MULTIPLY>(lhs, rhs); }
+
+    template<typename L, typename R> requires detail::Operands<L, R>
+    constexpr auto operator/(const L& lhs, const R& rhs) { return detail::make<Operations::DIVIDE>(lhs, rhs); }
+
+    template<Expression E>
+    constexpr auto operator-(const E& operand) { return detail::make<Operations::SUBTRACT>(constant(0), operand); }
+
+    /**
+     * Evaluates a formula, usable in constant expressions when the inputs are constants
+     */
+    template<Expression E, typename T, std::size_t N>
+    constexpr auto evaluate(const E& expression, const std::array<T, N>& inputs) -> T {
+        return expression.eval(inputs);
+    }
+
+    /**
+     * Value and gradient against every input in one pass
+     */
+    template<Expression E, typename T, std::size_t N>
+    constexpr auto value_and_grad(const E& expression, const std::array<T, N>& inputs) -> Dual<T, N> {
+        return expression.eval_dual(inputs);
+    }
+
+    /**
+     * Bridge from the dynamic graph: reads the current values of ScalarValue leaves
+     */
+    template<Expression E, typename T, std::size_t N>
+    auto evaluate(const E& expression, const std::array<ScalarValue<T>, N>& leaves) -> T {
+        std::array<T, N> inputs;
+        std::ranges::transform(leaves, inputs.begin(), [](const ScalarValue<T>& leaf) { return leaf.get_value(); });
+        return evaluate(expression, inputs);
+    }
+
+    template<Expression E, typename T, std::size_t N>
+    auto value_and_grad(const E& expression, const std::array<ScalarValue<T>, N>& leaves) -> Dual<T, N> {
+        std::array<T, N> inputs;
+        std::ranges::transform(leaves, inputs.begin(), [](const ScalarValue<T>& leaf) { return leaf.get_value(); });
+        return value_and_grad(expression, inputs);
+    }
+
+    /**
+     * Bridge into the dynamic graph: builds the formula out of ScalarValue nodes over `leaves`,
+     * so the result can be traced, lowered and fused like a hand written expression. Variable I
+     * becomes leaves[I] itself (same node identity); constants become fresh leaves.
+     */
+    template<Expression E, typename T, std::size_t N>
+    auto to_scalar_value(const E& expression, const std::array<ScalarValue<T>, N>& leaves) -> ScalarValue<T> {
+        return expression.to_value(leaves);
+    }
+}
+#endif //EXPRESSION_HPP
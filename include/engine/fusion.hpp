@@ -0,0 +1,476 @@
+#ifndef FUSION_HPP
+#define FUSION_HPP
+#include <ostream>
+#include <bits/stdc++.h>
+
+#include "value.hpp"
+#include "utils.hpp"
+
+namespace PlexiStruct::Engine::fusion {
+
+    /**
+     * One step of a postfix kernel program. NO_OPERATION loads kernel input `operand`,
+     * every other operation pops two values and pushes the result.
+     */
+    struct Instruction {
+        Operations op { Operations::NO_OPERATION };
+        std::size_t operand { 0 };
+
+        static auto load(const std::size_t input) -> Instruction {
+            return {.op = Operations::NO_OPERATION, .operand = input};
+        }
+
+        static auto apply(const Operations op) -> Instruction {
+            return {.op = op};
+        }
+    };
+
+    /**
+     * Elementwise kernel running a whole chain of operations in one pass over memory.
+     * The data is walked in tiles of TILE elements; every intermediate of the chain only
+     * ever lives in a tile sized scratch buffer that stays in cache.
+     */
+    template<typename T>
+    class FusedKernel {
+    public:
+        static constexpr std::size_t TILE = 256;
+
+    private:
+        struct Step {
+            Operations op;
+            std::size_t operand; // kernel input for loads
+            std::size_t lhs;     // program indices of the operands for operations
+            std::size_t rhs;
+        };
+
+        std::vector<Step> steps_;
+        std::size_t input_count_ { 0 };
+
+        static auto apply(const Operations op, const T lhs, const T rhs) -> T {
+            switch (op) {
+                case Operations::ADD: return lhs + rhs;
+                case Operations::SUBTRACT: return lhs - rhs;
+                case Operations::MULTIPLY: return lhs * rhs;
+                case Operations::DIVIDE: return lhs / rhs;
+                case Operations::NO_OPERATION: return lhs;
+            }
+            return lhs;
+        }
+
+        /**
+         * Evaluates every step over one tile, scratch holds steps_.size() rows of TILE values
+         */
+        auto run_tile(const std::vector<std::span<const T>>& inputs, const std::size_t offset,
+                      const std::size_t count, std::span<T> scratch) const -> void {
+            for (std::size_t s = 0; s < steps_.size(); ++s) {
+                const Step& step = steps_[s];
+                T* row = scratch.data() + s * TILE;
+                if (step.op == Operations::NO_OPERATION) {
+                    std::copy_n(inputs[step.operand].data() + offset, count, row);
+                    continue;
+                }
+                const T* lhs = scratch.data() + step.lhs * TILE;
+                const T* rhs = scratch.data() + step.rhs * TILE;
+                switch (step.op) {
+                    case Operations::ADD: for (std::size_t t = 0; t < count; ++t) { row[t] = lhs[t] + rhs[t]; } break;
+                    case Operations::SUBTRACT: for (std::size_t t = 0; t < count; ++t) { row[t] = lhs[t] - rhs[t]; } break;
+                    case Operations::MULTIPLY: for (std::size_t t = 0; t < count; ++t) { row[t] = lhs[t] * rhs[t]; } break;
+                    case Operations::DIVIDE: for (std::size_t t = 0; t < count; ++t) { row[t] = lhs[t] / rhs[t]; } break;
+                    case Operations::NO_OPERATION: break;
+                }
+            }
+        }
+
+    public:
+        FusedKernel() = default;
+
+        explicit FusedKernel(const std::vector<Instruction>& program) {
+            std::vector<std::size_t> stack;
+            for (const auto& instruction: program) {
+                if (instruction.op == Operations::NO_OPERATION) {
+                    input_count_ = std::max(input_count_, instruction.operand + 1);
+                    stack.push_back(steps_.size());
+                    steps_.push_back({instruction.op, instruction.operand, 0, 0});
+                    continue;
+                }
+                if (stack.size() < 2) {
+                    throw std::invalid_argument("FusedKernel: operation without two operands");
+                }
+                const std::size_t rhs = stack.back();
+                stack.pop_back();
+                const std::size_t lhs = stack.back();
+                stack.pop_back();
+                stack.push_back(steps_.size());
+                steps_.push_back({instruction.op, 0, lhs, rhs});
+            }
+            if (stack.size() != 1) {
+                throw std::invalid_argument("FusedKernel: program must leave exactly one value");
+            }
+        }
+
+        [[nodiscard]]
+        auto get_input_count() const -> std::size_t { return input_count_; }
+
+        [[nodiscard]]
+        auto get_operation_count() const -> std::size_t {
+            return std::ranges::count_if(steps_, [](const Step& step) { return step.op != Operations::NO_OPERATION; });
+        }
+
+        [[nodiscard]]
+        auto get_program() const -> std::vector<Instruction> {
+            std::vector<Instruction> program;
+            for (const auto& step: steps_) {
+                program.push_back({.op = step.op, .operand = step.operand});
+            }
+            return program;
+        }
+
+        /**
+         * Single element evaluation
+         */
+        [[nodiscard]]
+        auto evaluate(std::span<const T> inputs) const -> T {
+            std::vector<T> values(steps_.size());
+            for (std::size_t s = 0; s < steps_.size(); ++s) {
+                const Step& step = steps_[s];
+                values[s] = step.op == Operations::NO_OPERATION
+                    ? inputs[step.operand]
+                    : apply(step.op, values[step.lhs], values[step.rhs]);
+            }
+            return values.back();
+        }
+
+        [[nodiscard]]
+        auto get_scratch_size() const -> std::size_t { return steps_.size() * TILE; }
+
+        auto forward(const std::vector<std::span<const T>>& inputs, std::span<T> output) const -> void {
+            std::vector<T> scratch(get_scratch_size());
+            forward(inputs, output, scratch);
+        }
+
+        /**
+         * Allocation free variant, scratch must hold get_scratch_size() elements. Every input
+         * tile is read before the output tile is written, so the output may alias an input.
+         */
+        auto forward(const std::vector<std::span<const T>>& inputs, std::span<T> output, std::span<T> scratch) const -> void {
+            for (std::size_t offset = 0; offset < output.size(); offset += TILE) {
+                const std::size_t count = std::min(TILE, output.size() - offset);
+                run_tile(inputs, offset, count, scratch);
+                std::copy_n(scratch.data() + (steps_.size() - 1) * TILE, count, output.data() + offset);
+            }
+        }
+
+        /**
+         * Accumulates d(output)/d(input) * grad_output into every grad_inputs span. Each tile is
+         * recomputed forward and then swept in reverse, so no forward intermediates are stored.
+         */
+        auto backward(const std::vector<std::span<const T>>& inputs, std::span<const T> grad_output,
+                      const std::vector<std::span<T>>& grad_inputs) const -> void {
+            std::vector<T> scratch(steps_.size() * TILE);
+            std::vector<T> adjoints(steps_.size() * TILE);
+            for (std::size_t offset = 0; offset < grad_output.size(); offset += TILE) {
+                const std::size_t count = std::min(TILE, grad_output.size() - offset);
+                run_tile(inputs, offset, count, scratch);
+                std::ranges::fill(adjoints, T{ 0 });
+                std::copy_n(grad_output.data() + offset, count, adjoints.data() + (steps_.size() - 1) * TILE);
+
+                for (std::size_t s = steps_.size(); s-- > 0;) {
+                    const Step& step = steps_[s];
+                    const T* grad = adjoints.data() + s * TILE;
+                    if (step.op == Operations::NO_OPERATION) {
+                        T* dst = grad_inputs[step.operand].data() + offset;
+                        for (std::size_t t = 0; t < count; ++t) { dst[t] += grad[t]; }
+                        continue;
+                    }
+                    T* lhs_grad = adjoints.data() + step.lhs * TILE;
+                    T* rhs_grad = adjoints.data() + step.rhs * TILE;
+                    const T* lhs = scratch.data() + step.lhs * TILE;
+                    const T* rhs = scratch.data() + step.rhs * TILE;
+                    for (std::size_t t = 0; t < count; ++t) {
+                        switch (step.op) {
+                            case Operations::ADD: lhs_grad[t] += grad[t]; rhs_grad[t] += grad[t]; break;
+                            case Operations::SUBTRACT: lhs_grad[t] += grad[t]; rhs_grad[t] -= grad[t]; break;
+                            case Operations::MULTIPLY: lhs_grad[t] += grad[t] * rhs[t]; rhs_grad[t] += grad[t] * lhs[t]; break;
+                            case Operations::DIVIDE:
+                                lhs_grad[t] += grad[t] / rhs[t];
+                                rhs_grad[t] -= grad[t] * lhs[t] / (rhs[t] * rhs[t]);
+                                break;
+                            case Operations::NO_OPERATION: break;
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    /**
+     * A node of a lowered graph. Leaves have no inputs, every other node runs its kernel
+     * over the outputs of `inputs` (kernel input i reads node inputs[i]).
+     */
+    template<typename T>
+    struct Node {
+        std::vector<std::size_t> inputs;
+        FusedKernel<T> kernel;
+        T value { 0 };
+
+        [[nodiscard]]
+        auto is_leaf() const -> bool { return inputs.empty(); }
+    };
+
+    /**
+     * Nodes are stored in topological order, the root (graph output) is the last node
+     */
+    template<typename T>
+    struct Graph {
+        std::vector<Node<T>> nodes;
+
+        [[nodiscard]]
+        auto get_root() const -> std::size_t {
+            if (nodes.empty()) {
+                throw std::logic_error("Graph: an empty graph has no root");
+            }
+            return nodes.size() - 1;
+        }
+
+        [[nodiscard]]
+        auto get_leaves() const -> std::vector<std::size_t> {
+            std::vector<std::size_t> result;
+            for (std::size_t i = 0; i < nodes.size(); ++i) {
+                if (nodes[i].is_leaf()) {
+                    result.push_back(i);
+                }
+            }
+            return result;
+        }
+
+        [[nodiscard]]
+        auto get_consumer_counts() const -> std::vector<std::size_t> {
+            std::vector<std::size_t> result(nodes.size(), 0);
+            for (const auto& node: nodes) {
+                for (const auto input: node.inputs) {
+                    result[input] += 1;
+                }
+            }
+            return result;
+        }
+
+        /**
+         * Scalar evaluation using the traced leaf values
+         */
+        [[nodiscard]]
+        auto evaluate() const -> T {
+            std::vector<T> values(nodes.size());
+            for (std::size_t i = 0; i < nodes.size(); ++i) {
+                const auto& node = nodes[i];
+                if (node.is_leaf()) {
+                    values[i] = node.value;
+                    continue;
+                }
+                std::vector<T> arguments;
+                for (const auto input: node.inputs) {
+                    arguments.push_back(values[input]);
+                }
+                values[i] = node.kernel.evaluate(arguments);
+            }
+            return values[get_root()];
+        }
+    };
+
+    /**
+     * Turns the output of TraceBuilder into an indexed graph with one single op kernel per
+     * operation node. Nodes are keyed by ScalarValue id and take their operands in the order
+     * the operation recorded them. Throws when the trace does not have exactly one root.
+     */
+    template<typename T>
+    auto lower(const Utils::TraceObj<T>& trace) -> Graph<T> {
+        std::set<std::size_t> consumed;
+        for (const auto& edge: trace.edges) {
+            consumed.insert(edge.from.get_id());
+        }
+        std::vector<ScalarValue<T>> roots;
+        for (const auto& node: trace.nodes) {
+            if (!consumed.contains(node.get_id())) {
+                roots.push_back(node);
+            }
+        }
+        if (roots.size() != 1) {
+            throw std::invalid_argument("lower: trace must have exactly one root, found " + std::to_string(roots.size()));
+        }
+
+        Graph<T> graph;
+        std::map<std::size_t, std::size_t> index;
+        const auto visit = [&](const auto& self, const ScalarValue<T>& value) -> std::size_t {
+            if (const auto it = index.find(value.get_id()); it != index.end()) {
+                return it->second;
+            }
+            Node<T> node { .inputs = {}, .kernel = {}, .value = value.get_value() };
+            if (const auto op = value.get_operations(); op != Operations::NO_OPERATION) {
+                const auto operands = value.get_children();
+                if (operands.size() != 2) {
+                    throw std::invalid_argument("lower: binary operation with " + std::to_string(operands.size()) + " operands");
+                }
+                for (const auto& operand: operands) {
+                    node.inputs.push_back(self(self, operand));
+                }
+                node.kernel = FusedKernel<T>({Instruction::load(0), Instruction::load(1), Instruction::apply(op)});
+            }
+            index.emplace(value.get_id(), graph.nodes.size());
+            graph.nodes.push_back(std::move(node));
+            return graph.nodes.size() - 1;
+        };
+        visit(visit, roots.front());
+        return graph;
+    }
+
+    struct FusionReport {
+        std::size_t nodes_before { 0 };
+        std::size_t nodes_after { 0 };
+        std::size_t bytes_eliminated { 0 };
+
+        [[nodiscard]]
+        auto get_nodes_eliminated() const -> std::size_t { return nodes_before - nodes_after; }
+
+        friend std::ostream& operator<<(std::ostream& os, const FusionReport& obj) {
+            return os << "FusionReport( nodes : " << obj.nodes_before << " -> " << obj.nodes_after
+                      << ", eliminated : " << obj.get_nodes_eliminated()
+                      << ", intermediate bytes eliminated : " << obj.bytes_eliminated << " )";
+        }
+    };
+
+    /**
+     * Folds every operation node with exactly one consumer into that consumer, which leaves
+     * one fused kernel per maximal single consumer elementwise subtree. `elements` is the
+     * number of elements each node produces at tensor scale and only feeds the report.
+     */
+    template<typename T>
+    auto fuse(const Graph<T>& graph, const std::size_t elements = 1) -> std::pair<Graph<T>, FusionReport> {
+        const auto consumers = graph.get_consumer_counts();
+        const auto absorbed = [&](const std::size_t i) {
+            return !graph.nodes[i].is_leaf() && consumers[i] == 1 && i != graph.get_root();
+        };
+
+        Graph<T> result;
+        std::vector<std::size_t> remap(graph.nodes.size(), 0);
+        for (std::size_t i = 0; i < graph.nodes.size(); ++i) {
+            if (absorbed(i)) {
+                continue;
+            }
+            const auto& source = graph.nodes[i];
+            Node<T> node { .inputs = {}, .kernel = {}, .value = source.value };
+            if (!source.is_leaf()) {
+                std::vector<Instruction> program;
+                std::map<std::size_t, std::size_t> slots;
+                const auto emit = [&](const auto& self, const std::size_t current) -> void {
+                    for (const auto& instruction: graph.nodes[current].kernel.get_program()) {
+                        if (instruction.op != Operations::NO_OPERATION) {
+                            program.push_back(instruction);
+                            continue;
+                        }
+                        const std::size_t input = graph.nodes[current].inputs[instruction.operand];
+                        if (absorbed(input)) {
+                            self(self, input);
+                            continue;
+                        }
+                        const auto [slot, inserted] = slots.try_emplace(input, node.inputs.size());
+                        if (inserted) {
+                            node.inputs.push_back(remap[input]);
+                        }
+                        program.push_back(Instruction::load(slot->second));
+                    }
+                };
+                emit(emit, i);
+                node.kernel = FusedKernel<T>(program);
+            }
+            remap[i] = result.nodes.size();
+            result.nodes.push_back(std::move(node));
+        }
+
+        const FusionReport report {
+            .nodes_before = graph.nodes.size(),
+            .nodes_after = result.nodes.size(),
+            .bytes_eliminated = (graph.nodes.size() - result.nodes.size()) * elements * sizeof(T)
+        };
+        return {std::move(result), report};
+    }
+
+    /**
+     * Throws std::invalid_argument unless there is one span per graph leaf and every span
+     * holds exactly `elements` values
+     */
+    template<typename T>
+    auto validate_leaves(const Graph<T>& graph, const std::vector<std::span<const T>>& leaves,
+                         const std::size_t elements) -> void {
+        const std::size_t expected = graph.get_leaves().size();
+        if (leaves.size() != expected) {
+            throw std::invalid_argument("fusion: expected " + std::to_string(expected) + " leaves, got " + std::to_string(leaves.size()));
+        }
+        for (std::size_t l = 0; l < leaves.size(); ++l) {
+            if (leaves[l].size() != elements) {
+                throw std::invalid_argument("fusion: leaf " + std::to_string(l) + " has " + std::to_string(leaves[l].size())
+                                            + " elements, expected " + std::to_string(elements));
+            }
+        }
+    }
+
+    /**
+     * Runs a graph at tensor scale, materialising one buffer per node.
+     * `leaves` holds the data of the graph leaves in get_leaves() order.
+     */
+    template<typename T>
+    auto forward(const Graph<T>& graph, const std::vector<std::span<const T>>& leaves,
+                 const std::size_t elements) -> std::vector<std::vector<T>> {
+        validate_leaves(graph, leaves, elements);
+        std::vector<std::vector<T>> buffers(graph.nodes.size());
+        std::size_t next_leaf = 0;
+        for (std::size_t i = 0; i < graph.nodes.size(); ++i) {
+            const auto& node = graph.nodes[i];
+            if (node.is_leaf()) {
+                const auto data = leaves[next_leaf++];
+                buffers[i].assign(data.begin(), data.end());
+                continue;
+            }
+            std::vector<std::span<const T>> inputs;
+            for (const auto input: node.inputs) {
+                inputs.emplace_back(buffers[input]);
+            }
+            buffers[i].resize(elements);
+            node.kernel.forward(inputs, buffers[i]);
+        }
+        return buffers;
+    }
+
+    /**
+     * Reverse pass over the buffers produced by forward, returns the gradient of every node
+     */
+    template<typename T>
+    auto backward(const Graph<T>& graph, const std::vector<std::vector<T>>& buffers,
+                  std::span<const T> grad_output) -> std::vector<std::vector<T>> {
+        if (buffers.size() != graph.nodes.size()) {
+            throw std::invalid_argument("fusion: expected " + std::to_string(graph.nodes.size()) + " buffers, got " + std::to_string(buffers.size()));
+        }
+        if (grad_output.size() != buffers[graph.get_root()].size()) {
+            throw std::invalid_argument("fusion: output gradient has " + std::to_string(grad_output.size())
+                                        + " elements, root buffer has " + std::to_string(buffers[graph.get_root()].size()));
+        }
+        std::vector<std::vector<T>> grads(graph.nodes.size());
+        for (std::size_t i = 0; i < graph.nodes.size(); ++i) {
+            grads[i].assign(buffers[i].size(), T{ 0 });
+        }
+        std::ranges::copy(grad_output, grads[graph.get_root()].begin());
+        for (std::size_t i = graph.nodes.size(); i-- > 0;) {
+            const auto& node = graph.nodes[i];
+            if (node.is_leaf()) {
+                continue;
+            }
+            std::vector<std::span<const T>> inputs;
+            std::vector<std::span<T>> input_grads;
+            for (const auto input: node.inputs) {
+                inputs.emplace_back(buffers[input]);
+                input_grads.emplace_back(grads[input]);
+            }
+            node.kernel.backward(inputs, grads[i], input_grads);
+        }
+        return grads;
+    }
+}
+#endif //FUSION_HPP
@@ -0,0 +1,234 @@
+#ifndef MEMORY_PLANNER_HPP
+#define MEMORY_PLANNER_HPP
+#include <ostream>
+#include <bits/stdc++.h>
+
+#include "fusion.hpp"
+
+namespace PlexiStruct::Engine::memory {
+
+    /**
+     * Steps [begin, end] of the topological order during which a value has to stay alive
+     */
+    struct LiveRange {
+        std::size_t begin { 0 };
+        std::size_t end { 0 };
+        std::size_t elements { 0 };
+    };
+
+    /**
+     * Where every node writes its output. Leaves are bound to caller memory and get no buffer.
+     */
+    struct MemoryPlan {
+        std::vector<std::optional<std::size_t>> offsets;
+        std::vector<std::size_t> buffer_capacities;
+        std::size_t slab_elements { 0 };
+        std::size_t naive_elements { 0 };
+    };
+
+    /**
+     * Live range of every non leaf node of a graph in forward execution. A value dies at
+     * its last consumer; the root stays alive past the last step so it can be read back.
+     */
+    template<typename T>
+    auto live_ranges(const fusion::Graph<T>& graph, const std::size_t elements) -> std::vector<std::optional<LiveRange>> {
+        std::vector<std::optional<LiveRange>> ranges(graph.nodes.size());
+        for (std::size_t i = 0; i < graph.nodes.size(); ++i) {
+            if (!graph.nodes[i].is_leaf()) {
+                ranges[i] = LiveRange{.begin = i, .end = i, .elements = elements};
+            }
+            for (const auto input: graph.nodes[i].inputs) {
+                if (ranges[input]) {
+                    ranges[input]->end = std::max(ranges[input]->end, i);
+                }
+            }
+        }
+        if (!graph.nodes.empty() && ranges[graph.get_root()]) {
+            ranges[graph.get_root()]->end = graph.nodes.size();
+        }
+        return ranges;
+    }
+
+    /**
+     * Interval graph colouring. Ranges are visited by start step; a buffer whose owner died
+     * is returned to the free pool and handed to the next range, preferring the smallest
+     * free buffer that is big enough. A value may take over the buffer of an input it
+     * consumes for the last time, fused kernels read each input tile before writing.
+     */
+    inline auto plan(const std::vector<std::optional<LiveRange>>& ranges) -> MemoryPlan {
+        MemoryPlan result;
+        result.offsets.resize(ranges.size());
+
+        std::vector<std::size_t> order;
+        for (std::size_t i = 0; i < ranges.size(); ++i) {
+            if (ranges[i]) {
+                order.push_back(i);
+                result.naive_elements += ranges[i]->elements;
+            }
+        }
+        std::ranges::stable_sort(order, {}, [&](const std::size_t i) { return ranges[i]->begin; });
+
+        using Active = std::pair<std::size_t, std::size_t>; // (end, buffer)
+        std::priority_queue<Active, std::vector<Active>, std::greater<>> active;
+        std::multimap<std::size_t, std::size_t> free_buffers; // capacity -> buffer
+        std::vector<std::size_t> assignment(ranges.size(), 0);
+
+        for (const auto i: order) {
+            const LiveRange& range = *ranges[i];
+            while (!active.empty() && active.top().first <= range.begin) {
+                const auto buffer = active.top().second;
+                free_buffers.emplace(result.buffer_capacities[buffer], buffer);
+                active.pop();
+            }
+
+            std::size_t buffer;
+            if (auto it = free_buffers.lower_bound(range.elements); it != free_buffers.end()) {
+                buffer = it->second;
+                free_buffers.erase(it);
+            } else if (!free_buffers.empty()) {
+                auto largest = std::prev(free_buffers.end());
+                buffer = largest->second;
+                free_buffers.erase(largest);
+                result.buffer_capacities[buffer] = range.elements;
+            } else {
+                buffer = result.buffer_capacities.size();
+                result.buffer_capacities.push_back(range.elements);
+            }
+            assignment[i] = buffer;
+            active.emplace(range.end, buffer);
+        }
+
+        std::vector<std::size_t> buffer_offsets(result.buffer_capacities.size(), 0);
+        for (std::size_t b = 0; b < result.buffer_capacities.size(); ++b) {
+            buffer_offsets[b] = result.slab_elements;
+            result.slab_elements += result.buffer_capacities[b];
+        }
+        for (const auto i: order) {
+            result.offsets[i] = buffer_offsets[assignment[i]];
+        }
+        return result;
+    }
+
+    struct MemoryReport {
+        std::size_t naive_bytes { 0 };
+        std::size_t planned_bytes { 0 };
+        std::size_t buffer_count { 0 };
+
+        friend std::ostream& operator<<(std::ostream& os, const MemoryReport& obj) {
+            return os << "MemoryReport( peak naive : " << obj.naive_bytes
+                      << " bytes, peak planned : " << obj.planned_bytes
+                      << " bytes, buffers : " << obj.buffer_count << " )";
+        }
+    };
+
+    /**
+     * Forward executor over a planned graph. The first run allocates the slab, the kernel
+     * scratch and the per node argument tables; every later run only rebinds the leaf spans.
+     * When the root is itself a leaf, run() hands back the caller's leaf data.
+     */
+    template<typename T>
+    class PlannedExecutor {
+        fusion::Graph<T> graph_;
+        std::size_t elements_;
+        MemoryPlan plan_;
+        std::vector<T> slab_;
+        std::vector<T> scratch_;
+        std::vector<std::vector<std::span<const T>>> arguments_;
+        std::vector<std::size_t> leaf_slots_;
+        std::size_t leaf_count_ { 0 };
+        bool warmed_up_ { false };
+
+        auto output_of(const std::size_t node) -> std::span<T> {
+            return std::span<T>(slab_).subspan(*plan_.offsets[node], elements_);
+        }
+
+        auto warm_up() -> void {
+            slab_.resize(plan_.slab_elements);
+
+            std::size_t scratch_size = 0;
+            for (const auto& node: graph_.nodes) {
+                scratch_size = std::max(scratch_size, node.kernel.get_scratch_size());
+            }
+            scratch_.resize(scratch_size);
+
+            const auto leaves = graph_.get_leaves();
+            leaf_count_ = leaves.size();
+            leaf_slots_.assign(graph_.nodes.size(), 0);
+            for (std::size_t l = 0; l < leaves.size(); ++l) {
+                leaf_slots_[leaves[l]] = l;
+            }
+            arguments_.resize(graph_.nodes.size());
+            for (std::size_t i = 0; i < graph_.nodes.size(); ++i) {
+                if (graph_.nodes[i].is_leaf()) {
+                    continue;
+                }
+                arguments_[i].resize(graph_.nodes[i].inputs.size());
+                for (std::size_t a = 0; a < graph_.nodes[i].inputs.size(); ++a) {
+                    const auto input = graph_.nodes[i].inputs[a];
+                    if (!graph_.nodes[input].is_leaf()) {
+                        arguments_[i][a] = output_of(input);
+                    }
+                }
+            }
+        }
+
+    public:
+        explicit PlannedExecutor(fusion::Graph<T> graph, const std::size_t elements)
+        : graph_(std::move(graph)), elements_(elements), plan_(plan(live_ranges(graph_, elements))) {
+            if (graph_.nodes.empty()) {
+                throw std::invalid_argument("PlannedExecutor: graph has no nodes");
+            }
+        }
+
+        [[nodiscard]]
+        auto get_plan() const -> const MemoryPlan& { return plan_; }
+
+        /**
+         * `leaves` holds the data of the graph leaves in get_leaves() order, each exactly
+         * `elements` long
+         */
+        auto run(const std::vector<std::span<const T>>& leaves) -> std::span<const T> {
+            if (!warmed_up_) {
+                warm_up();
+                warmed_up_ = true;
+            }
+            if (leaves.size() != leaf_count_) {
+                throw std::invalid_argument("PlannedExecutor: expected " + std::to_string(leaf_count_) + " leaves, got " + std::to_string(leaves.size()));
+            }
+            // Checked inline rather than with fusion::validate_leaves, which allocates
+            for (std::size_t l = 0; l < leaves.size(); ++l) {
+                if (leaves[l].size() != elements_) {
+                    throw std::invalid_argument("PlannedExecutor: leaf " + std::to_string(l) + " has " + std::to_string(leaves[l].size())
+                                                + " elements, expected " + std::to_string(elements_));
+                }
+            }
+            const std::size_t root = graph_.get_root();
+            if (graph_.nodes[root].is_leaf()) {
+                return leaves[leaf_slots_[root]];
+            }
+            for (std::size_t i = 0; i < graph_.nodes.size(); ++i) {
+                const auto& node = graph_.nodes[i];
+                if (node.is_leaf()) {
+                    continue;
+                }
+                for (std::size_t a = 0; a < node.inputs.size(); ++a) {
+                    if (graph_.nodes[node.inputs[a]].is_leaf()) {
+                        arguments_[i][a] = leaves[leaf_slots_[node.inputs[a]]];
+                    }
+                }
+                node.kernel.forward(arguments_[i], output_of(i), scratch_);
+            }
+            return output_of(root);
+        }
+
+        [[nodiscard]]
+        auto get_report() const -> MemoryReport {
+            return MemoryReport {
+                .naive_bytes = plan_.naive_elements * sizeof(T),
+                .planned_bytes = plan_.slab_elements * sizeof(T),
+                .buffer_count = plan_.buffer_capacities.size()
+            };
+        }
+    };
+}
+#endif //MEMORY_PLANNER_HPP
@@ -0,0 +1,390 @@
+#ifndef PRECISION_HPP
+#define PRECISION_HPP
+#include <ostream>
+#include <bits/stdc++.h>
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace PlexiStruct::Engine {
+
+    enum class FloatFormat: std::uint8_t {
+        FP16, BF16
+    };
+
+    namespace detail {
+        constexpr auto float_bits(const float value) -> std::uint32_t {
+            return std::bit_cast<std::uint32_t>(value);
+        }
+
+        constexpr auto bits_float(const std::uint32_t bits) -> float {
+            return std::bit_cast<float>(bits);
+        }
+
+        /**
+         * All ones when condition holds, zero otherwise. Selecting through masks instead of
+         * ?: keeps the codecs free of control flow, which the vectoriser requires.
+         */
+        constexpr auto mask_of(const bool condition) -> std::uint32_t {
+            return 0u - static_cast<std::uint32_t>(condition);
+        }
+
+        constexpr auto select(const std::uint32_t mask, const std::uint32_t if_set, const std::uint32_t if_clear) -> std::uint32_t {
+            return (if_set & mask) | (if_clear & ~mask);
+        }
+
+        /**
+         * Round to nearest even by adding the rounding bias before truncating the low half
+         */
+        constexpr auto float_to_bf16(const float value) -> std::uint16_t {
+            const std::uint32_t bits = float_bits(value);
+            const std::uint32_t rounding_bias = 0x7FFFu + ((bits >> 16) & 1u);
+            const std::uint32_t rounded = (bits + rounding_bias) >> 16;
+            const std::uint32_t quiet_nan = (bits >> 16) | 0x0040u;
+            return static_cast<std::uint16_t>(select(mask_of((bits & 0x7FFFFFFFu) > 0x7F800000u), quiet_nan, rounded));
+        }
+
+        constexpr auto bf16_to_float(const std::uint16_t bits) -> float {
+            return bits_float(static_cast<std::uint32_t>(bits) << 16);
+        }
+
+        /**
+         * IEEE binary32 -> binary16 with round to nearest even, subnormals are produced
+         * by letting the float adder do the alignment shift against a magic constant
+         */
+        constexpr auto float_to_fp16(const float value) -> std::uint16_t {
+            constexpr std::uint32_t f32_infinity = 255u << 23;
+            constexpr std::uint32_t f16_overflow = (127u + 16u) << 23;
+            constexpr std::uint32_t denormal_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+            std::uint32_t bits = float_bits(value);
+            const std::uint32_t sign = bits & 0x80000000u;
+            bits ^= sign;
+
+            // All three cases are computed and selected so the loop bodies stay branch free
+            const std::uint32_t special = 0x7C00u | (mask_of(bits > f32_infinity) & 0x0200u);
+            const std::uint32_t subnormal = float_bits(bits_float(bits) + bits_float(denormal_magic)) - denormal_magic;
+            const std::uint32_t mantissa_odd = (bits >> 13) & 1u;
+            const std::uint32_t normal = (bits + ((15u - 127u) << 23) + 0xFFFu + mantissa_odd) >> 13;
+
+            std::uint32_t result = select(mask_of(bits < (113u << 23)), subnormal, normal);
+            result = select(mask_of(bits >= f16_overflow), special, result);
+            return static_cast<std::uint16_t>(result | (sign >> 16));
+        }
+
+        constexpr auto fp16_to_float(const std::uint16_t half) -> float {
+            constexpr std::uint32_t magic = 113u << 23;
+            constexpr std::uint32_t shifted_exponent = 0x7C00u << 13;
+
+            const std::uint32_t shifted = (static_cast<std::uint32_t>(half) & 0x7FFFu) << 13;
+            const std::uint32_t exponent = shifted & shifted_exponent;
+            const std::uint32_t normal = shifted + ((127u - 15u) << 23);
+            const std::uint32_t special = normal + ((128u - 16u) << 23); // inf / NaN
+            // zero / subnormal, renormalised through the float unit
+            const std::uint32_t subnormal = float_bits(bits_float(normal + (1u << 23)) - bits_float(magic));
+
+            std::uint32_t bits = select(mask_of(exponent == 0), subnormal, normal);
+            bits = select(mask_of(exponent == shifted_exponent), special, bits);
+            return bits_float(bits | ((static_cast<std::uint32_t>(half) & 0x8000u) << 16));
+        }
+    }
+
+    /**
+     * 16 bit storage type, every arithmetic operation is carried out in float and rounded back
+     */
+    template<FloatFormat Format>
+    class ReducedFloat {
+        std::uint16_t bits_ { 0 };
+
+        static constexpr auto encode(const float value) -> std::uint16_t {
+            if constexpr (Format == FloatFormat::BF16) {
+                return detail::float_to_bf16(value);
+            } else {
+                return detail::float_to_fp16(value);
+            }
+        }
+
+    public:
+        constexpr ReducedFloat() = default;
+
+        template<typename U> requires std::is_arithmetic_v<U>
+        constexpr explicit ReducedFloat(const U value): bits_(encode(static_cast<float>(value))) {}
+
+        static constexpr auto from_bits(const std::uint16_t bits) -> ReducedFloat {
+            ReducedFloat result;
+            result.bits_ = bits;
+            return result;
+        }
+
+        [[nodiscard]]
+        constexpr auto get_bits() const -> std::uint16_t { return bits_; }
+
+        [[nodiscard]]
+        constexpr auto to_float() const -> float {
+            if constexpr (Format == FloatFormat::BF16) {
+                return detail::bf16_to_float(bits_);
+            } else {
+                return detail::fp16_to_float(bits_);
+            }
+        }
+
+        constexpr operator float() const { return to_float(); }
+
+        friend constexpr auto operator+(const ReducedFloat lhs, const ReducedFloat rhs) -> ReducedFloat {
+            return ReducedFloat(lhs.to_float() + rhs.to_float());
+        }
+
+        friend constexpr auto operator-(const ReducedFloat lhs, const ReducedFloat rhs) -> ReducedFloat {
+            return ReducedFloat(lhs.to_float() - rhs.to_float());
+        }
+
+        friend constexpr auto operator*(const ReducedFloat lhs, const ReducedFloat rhs) -> ReducedFloat {
+            return ReducedFloat(lhs.to_float() * rhs.to_float());
+        }
+
+        friend constexpr auto operator/(const ReducedFloat lhs, const ReducedFloat rhs) -> ReducedFloat {
+            return ReducedFloat(lhs.to_float() / rhs.to_float());
+        }
+
+        friend constexpr auto operator-(const ReducedFloat value) -> ReducedFloat {
+            return from_bits(static_cast<std::uint16_t>(value.bits_ ^ 0x8000u));
+        }
+
+        friend constexpr auto operator==(const ReducedFloat lhs, const ReducedFloat rhs) -> bool {
+            return lhs.to_float() == rhs.to_float();
+        }
+
+        friend constexpr auto operator<=>(const ReducedFloat lhs, const ReducedFloat rhs) -> std::partial_ordering {
+            return lhs.to_float() <=> rhs.to_float();
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const ReducedFloat& obj) {
+            return os << obj.to_float();
+        }
+    };
+
+    using float16 = ReducedFloat<FloatFormat::FP16>;
+    using bfloat16 = ReducedFloat<FloatFormat::BF16>;
+
+    static_assert(sizeof(float16) == 2 && sizeof(bfloat16) == 2, "bulk kernels reinterpret storage as raw halves");
+
+    /**
+     * Type used to accumulate reductions over values stored as T
+     */
+    template<typename T>
+    struct Accumulator {
+        using type = T;
+    };
+
+    template<FloatFormat Format>
+    struct Accumulator<ReducedFloat<Format>> {
+        using type = float;
+    };
+
+    template<typename T>
+    using accumulate_t = typename Accumulator<T>::type;
+
+    namespace kernels {
+        /**
+         * Bulk conversions. The codecs select with masks instead of branching, so these loops
+         * vectorise at plain -O3; float16 uses the F16C instructions when they are enabled
+         */
+        template<typename S>
+        auto to_storage(std::span<const float> input, std::span<S> output) -> void {
+            const std::size_t count = std::min(input.size(), output.size());
+            std::size_t i = 0;
+#if defined(__F16C__)
+            if constexpr (std::is_same_v<S, float16>) {
+                // Hardware conversion, eight lanes per instruction with round to nearest even
+                for (; i + 8 <= count; i += 8) {
+                    const __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(input.data() + i), _MM_FROUND_TO_NEAREST_INT);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(output.data() + i), half);
+                }
+            }
+#endif
+            for (; i < count; ++i) {
+                output[i] = S(input[i]);
+            }
+        }
+
+        template<typename S>
+        auto to_float(std::span<const S> input, std::span<float> output) -> void {
+            const std::size_t count = std::min(input.size(), output.size());
+            std::size_t i = 0;
+#if defined(__F16C__)
+            if constexpr (std::is_same_v<S, float16>) {
+                for (; i + 8 <= count; i += 8) {
+                    const __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + i));
+                    _mm256_storeu_ps(output.data() + i, _mm256_cvtph_ps(half));
+                }
+            }
+#endif
+            for (; i < count; ++i) {
+                output[i] = static_cast<float>(input[i]);
+            }
+        }
+
+        /**
+         * Reductions keep REDUCTION_LANES independent partial sums, which breaks the add
+         * dependency chain (and lets the compiler keep them in one vector register)
+         */
+        constexpr std::size_t REDUCTION_LANES = 8;
+
+        /**
+         * With F16C, float16 is widened DECODE_BLOCK values at a time through the hardware
+         * conversion in to_float, and the reduction then runs on plain floats. Everywhere
+         * else the inline integer codec is cheaper than the round trip through a buffer.
+         */
+        constexpr std::size_t DECODE_BLOCK = 256;
+
+        template<typename T>
+#if defined(__F16C__)
+        constexpr bool decodes_in_blocks = std::is_same_v<T, float16>;
+#else
+        constexpr bool decodes_in_blocks = false;
+#endif
+
+        template<typename T>
+        auto sum(std::span<const T> values) -> accumulate_t<T> {
+            if constexpr (decodes_in_blocks<T>) {
+                std::array<float, DECODE_BLOCK> block;
+                accumulate_t<T> total { 0 };
+                for (std::size_t i = 0; i < values.size(); i += DECODE_BLOCK) {
+                    const std::size_t count = std::min(DECODE_BLOCK, values.size() - i);
+                    to_float(values.subspan(i, count), std::span(block));
+                    total += sum(std::span<const float>(block.data(), count));
+                }
+                return total;
+            } else {
+                std::array<accumulate_t<T>, REDUCTION_LANES> lanes {};
+                const std::size_t blocked = values.size() - values.size() % REDUCTION_LANES;
+                for (std::size_t i = 0; i < blocked; i += REDUCTION_LANES) {
+                    for (std::size_t lane = 0; lane < REDUCTION_LANES; ++lane) {
+                        lanes[lane] += static_cast<accumulate_t<T>>(values[i + lane]);
+                    }
+                }
+                for (std::size_t i = blocked; i < values.size(); ++i) {
+                    lanes[0] += static_cast<accumulate_t<T>>(values[i]);
+                }
+                return std::accumulate(lanes.begin(), lanes.end(), accumulate_t<T>{ 0 });
+            }
+        }
+
+        template<typename T>
+        auto dot(std::span<const T> lhs, std::span<const T> rhs) -> accumulate_t<T> {
+            const std::size_t count = std::min(lhs.size(), rhs.size());
+            if constexpr (decodes_in_blocks<T>) {
+                std::array<float, DECODE_BLOCK> a;
+                std::array<float, DECODE_BLOCK> b;
+                accumulate_t<T> total { 0 };
+                for (std::size_t i = 0; i < count; i += DECODE_BLOCK) {
+                    const std::size_t block = std::min(DECODE_BLOCK, count - i);
+                    to_float(lhs.subspan(i, block), std::span(a));
+                    to_float(rhs.subspan(i, block), std::span(b));
+                    total += dot(std::span<const float>(a.data(), block), std::span<const float>(b.data(), block));
+                }
+                return total;
+            } else {
+                std::array<accumulate_t<T>, REDUCTION_LANES> lanes {};
+                const std::size_t blocked = count - count % REDUCTION_LANES;
+                for (std::size_t i = 0; i < blocked; i += REDUCTION_LANES) {
+                    for (std::size_t lane = 0; lane < REDUCTION_LANES; ++lane) {
+                        lanes[lane] += static_cast<accumulate_t<T>>(lhs[i + lane]) * static_cast<accumulate_t<T>>(rhs[i + lane]);
+                    }
+                }
+                for (std::size_t i = blocked; i < count; ++i) {
+                    lanes[0] += static_cast<accumulate_t<T>>(lhs[i]) * static_cast<accumulate_t<T>>(rhs[i]);
+                }
+                return std::accumulate(lanes.begin(), lanes.end(), accumulate_t<T>{ 0 });
+            }
+        }
+
+        /**
+         * y = alpha * x + y, computed in the accumulator type and stored back as T
+         */
+        template<typename T>
+        auto axpy(const accumulate_t<T> alpha, std::span<const T> x, std::span<T> y) -> void {
+            const std::size_t count = std::min(x.size(), y.size());
+            if constexpr (decodes_in_blocks<T>) {
+                std::array<float, DECODE_BLOCK> a;
+                std::array<float, DECODE_BLOCK> b;
+                for (std::size_t i = 0; i < count; i += DECODE_BLOCK) {
+                    const std::size_t block = std::min(DECODE_BLOCK, count - i);
+                    to_float(x.subspan(i, block), std::span(a));
+                    to_float(std::span<const T>(y.subspan(i, block)), std::span(b));
+                    axpy(alpha, std::span<const float>(a.data(), block), std::span<float>(b.data(), block));
+                    to_storage(std::span<const float>(b.data(), block), y.subspan(i, block));
+                }
+            } else {
+                for (std::size_t i = 0; i < count; ++i) {
+                    y[i] = T(alpha * static_cast<accumulate_t<T>>(x[i]) + static_cast<accumulate_t<T>>(y[i]));
+                }
+            }
+        }
+    }
+
+    /**
+     * Loss scaling for reduced precision training: the loss is multiplied by the scale
+     * before backward so small gradients survive fp16, then gradients are unscaled into
+     * fp32 master gradients (the reduced type never holds an unscaled value). Overflowing steps are skipped and shrink the scale, long clean runs grow it back.
+     */
+    class DynamicLossScaler {
+        float scale_ { 65536.0f };
+        float growth_factor_ { 2.0f };
+        float backoff_factor_ { 0.5f };
+        std::size_t growth_interval_ { 2000 };
+        std::size_t clean_steps_ { 0 };
+    public:
+        explicit DynamicLossScaler(const float initial_scale = 65536.0f, const std::size_t growth_interval = 2000)
+        : scale_(initial_scale), growth_interval_(growth_interval) {}
+
+        [[nodiscard]]
+        auto get_scale() const -> float { return scale_; }
+
+        [[nodiscard]]
+        auto scale(const float loss) const -> float { return loss * scale_; }
+
+        /**
+         * Writes scaled / scale into the fp32 master gradients, returns false when the step
+         * has to be skipped because some gradient overflowed
+         */
+        template<typename T>
+        auto unscale(std::span<const T> scaled, std::span<float> out) -> bool {
+            if (scaled.size() != out.size()) {
+                throw std::invalid_argument("DynamicLossScaler: " + std::to_string(scaled.size()) + " gradients but "
+                                            + std::to_string(out.size()) + " master slots");
+            }
+            const float inv_scale = 1.0f / scale_;
+            bool finite = true;
+            for (std::size_t i = 0; i < scaled.size(); ++i) {
+                out[i] = static_cast<float>(scaled[i]) * inv_scale;
+                finite = finite && std::isfinite(out[i]);
+            }
+            update(!finite);
+            return finite;
+        }
+
+        auto update(const bool found_overflow) -> void {
+            if (found_overflow) {
+                scale_ = std::max(scale_ * backoff_factor_, 1.0f);
+                clean_steps_ = 0;
+                return;
+            }
+            clean_steps_ += 1;
+            if (clean_steps_ == growth_interval_) {
+                scale_ *= growth_factor_;
+                clean_steps_ = 0;
+            }
+        }
+    };
+}
+
+template<PlexiStruct::Engine::FloatFormat Format>
+struct std::hash<PlexiStruct::Engine::ReducedFloat<Format>> {
+    auto operator()(const PlexiStruct::Engine::ReducedFloat<Format>& key) const -> std::size_t {
+        // Hash the float value so that +0 and -0 agree with operator==
+        return std::hash<float>()(key.to_float());
+    }
+};
+
+#endif //PRECISION_HPP
@@ -0,0 +1,417 @@
+#ifndef QUANTIZATION_HPP
+#define QUANTIZATION_HPP
+#include <ostream>
+#include <bits/stdc++.h>
+
+#include <xtensor/xtensor.hpp>
+
+namespace PlexiStruct::Engine::quant {
+
+    using Matrix = xt::xtensor<float, 2>;
+    using QMatrix = xt::xtensor<std::int8_t, 2>;
+
+    constexpr std::int32_t Q_MIN = std::numeric_limits<std::int8_t>::min();
+    constexpr std::int32_t Q_MAX = std::numeric_limits<std::int8_t>::max();
+
+    /**
+     * Affine mapping between float and int8: real = scale * (q - zero_point)
+     */
+    struct QuantParams {
+        float scale { 1.0f };
+        std::int32_t zero_point { 0 };
+
+        static auto from_range(float min_value, float max_value) -> QuantParams {
+            // The range must contain zero so that zero padding / relu are exact
+            min_value = std::min(min_value, 0.0f);
+            max_value = std::max(max_value, 0.0f);
+            if (max_value == min_value) {
+                return {};
+            }
+            const float scale = (max_value - min_value) / static_cast<float>(Q_MAX - Q_MIN);
+            const auto zero_point = static_cast<std::int32_t>(std::lround(Q_MIN - min_value / scale));
+            return {.scale = scale, .zero_point = std::clamp(zero_point, Q_MIN, Q_MAX)};
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const QuantParams& obj) {
+            return os << "QuantParams( scale : " << obj.scale << ", zero_point : " << obj.zero_point << " )";
+        }
+    };
+
+    /**
+     * Saturates in float before converting, so out of range inputs never reach an undefined
+     * float to int conversion. NaN maps to the zero point (real 0).
+     */
+    inline auto quantize_value(const float value, const float inv_scale, const std::int32_t zero_point) -> std::int8_t {
+        const float scaled = value * inv_scale;
+        const float bounded = std::isnan(scaled)
+            ? 0.0f
+            : std::clamp(scaled, static_cast<float>(Q_MIN - zero_point), static_cast<float>(Q_MAX - zero_point));
+        return static_cast<std::int8_t>(static_cast<std::int32_t>(std::nearbyint(bounded)) + zero_point);
+    }
+
+    /**
+     * Records the activation range seen at one point of the network during calibration
+     */
+    class CalibrationObserver {
+        float min_ { std::numeric_limits<float>::max() };
+        float max_ { std::numeric_limits<float>::lowest() };
+        std::size_t batches_ { 0 };
+    public:
+        auto observe(const Matrix& activations) -> void {
+            if (activations.size() == 0) {
+                return;
+            }
+            const auto [lo, hi] = std::minmax_element(activations.data(), activations.data() + activations.size());
+            min_ = std::min(min_, *lo);
+            max_ = std::max(max_, *hi);
+            batches_ += 1;
+        }
+
+        [[nodiscard]]
+        auto get_batch_count() const -> std::size_t { return batches_; }
+
+        [[nodiscard]]
+        auto get_params() const -> QuantParams {
+            if (batches_ == 0) {
+                return {};
+            }
+            return QuantParams::from_range(min_, max_);
+        }
+    };
+
+    inline auto quantize(const Matrix& input, const QuantParams& params) -> QMatrix {
+        QMatrix result = QMatrix::from_shape({input.shape()[0], input.shape()[1]});
+        const float inv_scale = 1.0f / params.scale;
+        const float* src = input.data();
+        std::int8_t* dst = result.data();
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            dst[i] = quantize_value(src[i], inv_scale, params.zero_point);
+        }
+        return result;
+    }
+
+    inline auto dequantize(const QMatrix& input, const QuantParams& params) -> Matrix {
+        Matrix result = Matrix::from_shape({input.shape()[0], input.shape()[1]});
+        const std::int8_t* src = input.data();
+        float* dst = result.data();
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            dst[i] = params.scale * static_cast<float>(static_cast<std::int32_t>(src[i]) - params.zero_point);
+        }
+        return result;
+    }
+
+    namespace kernels {
+        /**
+         * C[m, n] = sum_k A[m, k] * B[n, k] with int32 accumulation.
+         * B is stored row major as [N, K] (one output channel per row) so that the
+         * inner loop walks both operands contiguously, which lets the compiler
+         * widen it into packed multiply-add instructions.
+         */
+        inline auto gemm_s8s8s32(const std::int8_t* a, const std::int8_t* b, std::int32_t* c,
+                                 const std::size_t m, const std::size_t n, const std::size_t k) -> void {
+            for (std::size_t i = 0; i < m; ++i) {
+                const std::int8_t* a_row = a + i * k;
+                for (std::size_t j = 0; j < n; ++j) {
+                    const std::int8_t* b_row = b + j * k;
+                    std::int32_t acc = 0;
+                    for (std::size_t p = 0; p < k; ++p) {
+                        acc += static_cast<std::int16_t>(a_row[p]) * static_cast<std::int16_t>(b_row[p]);
+                    }
+                    c[i * n + j] = acc;
+                }
+            }
+        }
+
+        /**
+         * In place relu on int8 data; zero maps to the zero point
+         */
+        inline auto relu_s8(std::int8_t* data, const std::size_t count, const std::int32_t zero_point) -> void {
+            const auto zero = static_cast<std::int8_t>(zero_point);
+            for (std::size_t i = 0; i < count; ++i) {
+                data[i] = std::max(data[i], zero);
+            }
+        }
+    }
+
+    /**
+     * Symmetric per output channel int8 weights, rows are output channels
+     */
+    struct QuantizedWeights {
+        QMatrix values;
+        std::vector<float> scales;
+        std::vector<std::int32_t> row_sums;
+
+        static auto from(const Matrix& weights) -> QuantizedWeights {
+            const std::size_t rows = weights.shape()[0];
+            const std::size_t cols = weights.shape()[1];
+            QuantizedWeights result {
+                .values = QMatrix::from_shape({rows, cols}),
+                .scales = std::vector<float>(rows, 1.0f),
+                .row_sums = std::vector<std::int32_t>(rows, 0)
+            };
+            for (std::size_t r = 0; r < rows; ++r) {
+                const float* src = weights.data() + r * cols;
+                std::int8_t* dst = result.values.data() + r * cols;
+                float max_abs = 0.0f;
+                for (std::size_t c = 0; c < cols; ++c) {
+                    max_abs = std::max(max_abs, std::abs(src[c]));
+                }
+                const float scale = max_abs == 0.0f ? 1.0f : max_abs / static_cast<float>(Q_MAX);
+                const float inv_scale = 1.0f / scale;
+                std::int32_t sum = 0;
+                for (std::size_t c = 0; c < cols; ++c) {
+                    dst[c] = quantize_value(src[c], inv_scale, 0);
+                    sum += dst[c];
+                }
+                result.scales[r] = scale;
+                result.row_sums[r] = sum;
+            }
+            return result;
+        }
+    };
+
+    /**
+     * Float reference for y = x * W^T + b, W laid out as [out_features, in_features]
+     */
+    inline auto linear(const Matrix& input, const Matrix& weights, const std::vector<float>& bias) -> Matrix {
+        const std::size_t m = input.shape()[0];
+        const std::size_t k = input.shape()[1];
+        const std::size_t n = weights.shape()[0];
+        Matrix result = Matrix::from_shape({m, n});
+        for (std::size_t i = 0; i < m; ++i) {
+            const float* x_row = input.data() + i * k;
+            for (std::size_t j = 0; j < n; ++j) {
+                const float* w_row = weights.data() + j * k;
+                float acc = 0.0f;
+                for (std::size_t p = 0; p < k; ++p) {
+                    acc += x_row[p] * w_row[p];
+                }
+                result.data()[i * n + j] = acc + (bias.empty() ? 0.0f : bias[j]);
+            }
+        }
+        return result;
+    }
+
+    inline auto relu(Matrix input) -> Matrix {
+        std::for_each(input.data(), input.data() + input.size(), [](float& value) { value = std::max(value, 0.0f); });
+        return input;
+    }
+
+    /**
+     * Linear layer running int8 x int8 -> int32 with the input params fixed by calibration
+     */
+    class QuantizedLinear {
+        QuantizedWeights weights_;
+        std::vector<float> bias_;
+        QuantParams input_params_;
+
+        /**
+         * The input zero point is folded out of the int32 accumulator through the
+         * precomputed weight row sums: sum (x - z) * w = sum x * w - z * sum w
+         */
+        [[nodiscard]]
+        auto accumulate(const QMatrix& input) const -> std::vector<std::int32_t> {
+            const std::size_t m = input.shape()[0];
+            const std::size_t k = input.shape()[1];
+            const std::size_t n = weights_.values.shape()[0];
+            if (k != weights_.values.shape()[1]) {
+                throw std::invalid_argument("QuantizedLinear: input has " + std::to_string(k)
+                                            + " features, weights expect " + std::to_string(weights_.values.shape()[1]));
+            }
+            std::vector<std::int32_t> accumulators(m * n);
+            kernels::gemm_s8s8s32(input.data(), weights_.values.data(), accumulators.data(), m, n, k);
+            for (std::size_t i = 0; i < m; ++i) {
+                for (std::size_t j = 0; j < n; ++j) {
+                    accumulators[i * n + j] -= input_params_.zero_point * weights_.row_sums[j];
+                }
+            }
+            return accumulators;
+        }
+
+        [[nodiscard]]
+        auto output_scale(const std::size_t channel) const -> float {
+            return input_params_.scale * weights_.scales[channel];
+        }
+
+    public:
+        explicit QuantizedLinear(QuantizedWeights weights, std::vector<float> bias, const QuantParams& input_params)
+        : weights_(std::move(weights)), bias_(std::move(bias)), input_params_(input_params) {}
+
+        static auto from(const Matrix& weights, const std::vector<float>& bias, const CalibrationObserver& observer) -> QuantizedLinear {
+            return QuantizedLinear(QuantizedWeights::from(weights), bias, observer.get_params());
+        }
+
+        [[nodiscard]]
+        auto get_input_params() const -> QuantParams { return input_params_; }
+
+        [[nodiscard]]
+        auto get_output_features() const -> std::size_t { return weights_.values.shape()[0]; }
+
+        [[nodiscard]]
+        auto forward(const Matrix& input) const -> Matrix {
+            const QMatrix q_input = quantize(input, input_params_);
+            return forward_quantized(q_input);
+        }
+
+        /**
+         * int8 in, float out; used by the last layer of a network
+         */
+        [[nodiscard]]
+        auto forward_quantized(const QMatrix& input) const -> Matrix {
+            const std::size_t n = get_output_features();
+            const auto accumulators = accumulate(input);
+            Matrix result = Matrix::from_shape({input.shape()[0], n});
+            float* dst = result.data();
+            for (std::size_t i = 0; i < accumulators.size(); ++i) {
+                const std::size_t j = i % n;
+                dst[i] = static_cast<float>(accumulators[i]) * output_scale(j) + (bias_.empty() ? 0.0f : bias_[j]);
+            }
+            return result;
+        }
+
+        /**
+         * int8 in, int8 out: the int32 accumulators are requantized straight into the next
+         * layer's input params, optionally followed by an int8 relu
+         */
+        [[nodiscard]]
+        auto forward_requantized(const QMatrix& input, const QuantParams& output_params, const bool apply_relu) const -> QMatrix {
+            const std::size_t n = get_output_features();
+            const auto accumulators = accumulate(input);
+            QMatrix result = QMatrix::from_shape({input.shape()[0], n});
+            std::int8_t* dst = result.data();
+            const float inv_output_scale = 1.0f / output_params.scale;
+            for (std::size_t i = 0; i < accumulators.size(); ++i) {
+                const std::size_t j = i % n;
+                const float value = static_cast<float>(accumulators[i]) * output_scale(j) + (bias_.empty() ? 0.0f : bias_[j]);
+                dst[i] = quantize_value(value, inv_output_scale, output_params.zero_point);
+            }
+            if (apply_relu) {
+                kernels::relu_s8(dst, result.size(), output_params.zero_point);
+            }
+            return result;
+        }
+    };
+
+    /**
+     * Stack of linear layers with relu between them. The float version is the reference,
+     * the quantized version stays in int8 from the first quantize to the last layer.
+     */
+    class QuantizedMLP {
+        std::vector<QuantizedLinear> layers_;
+
+        static auto check_layers(const std::vector<Matrix>& weights, const std::vector<std::vector<float>>& biases) -> void {
+            if (weights.empty()) {
+                throw std::invalid_argument("QuantizedMLP: network has no layers");
+            }
+            if (biases.size() != weights.size()) {
+                throw std::invalid_argument("QuantizedMLP: " + std::to_string(weights.size()) + " weight matrices but "
+                                            + std::to_string(biases.size()) + " bias vectors");
+            }
+        }
+    public:
+        explicit QuantizedMLP(std::vector<QuantizedLinear> layers): layers_(std::move(layers)) {
+            if (layers_.empty()) {
+                throw std::invalid_argument("QuantizedMLP: network has no layers");
+            }
+        }
+
+        /**
+         * Float forward pass over the calibration samples, recording the input range of every layer
+         */
+        static auto calibrate(const std::vector<Matrix>& weights, const std::vector<std::vector<float>>& biases,
+                              const std::vector<Matrix>& samples) -> QuantizedMLP {
+            check_layers(weights, biases);
+            std::vector<CalibrationObserver> observers(weights.size());
+            for (const auto& sample: samples) {
+                Matrix activations = sample;
+                for (std::size_t l = 0; l < weights.size(); ++l) {
+                    observers[l].observe(activations);
+                    activations = linear(activations, weights[l], biases[l]);
+                    if (l + 1 < weights.size()) {
+                        activations = relu(std::move(activations));
+                    }
+                }
+            }
+            std::vector<QuantizedLinear> layers;
+            for (std::size_t l = 0; l < weights.size(); ++l) {
+                layers.push_back(QuantizedLinear::from(weights[l], biases[l], observers[l]));
+            }
+            return QuantizedMLP(std::move(layers));
+        }
+
+        static auto reference(const std::vector<Matrix>& weights, const std::vector<std::vector<float>>& biases,
+                              const Matrix& input) -> Matrix {
+            check_layers(weights, biases);
+            Matrix activations = input;
+            for (std::size_t l = 0; l < weights.size(); ++l) {
+                activations = linear(activations, weights[l], biases[l]);
+                if (l + 1 < weights.size()) {
+                    activations = relu(std::move(activations));
+                }
+            }
+            return activations;
+        }
+
+        [[nodiscard]]
+        auto forward(const Matrix& input) const -> Matrix {
+            QMatrix activations = quantize(input, layers_.front().get_input_params());
+            for (std::size_t l = 0; l + 1 < layers_.size(); ++l) {
+                activations = layers_[l].forward_requantized(activations, layers_[l + 1].get_input_params(), true);
+            }
+            return layers_.back().forward_quantized(activations);
+        }
+    };
+
+    struct QuantizationReport {
+        double max_abs_error { 0 };
+        double mean_abs_error { 0 };
+        double float_ms { 0 };
+        double int8_ms { 0 };
+
+        [[nodiscard]]
+        auto get_speedup() const -> double {
+            return int8_ms == 0 ? 0 : float_ms / int8_ms;
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const QuantizationReport& obj) {
+            return os << "QuantizationReport( max |delta| : " << obj.max_abs_error
+                      << ", mean |delta| : " << obj.mean_abs_error
+                      << ", float : " << obj.float_ms << " ms"
+                      << ", int8 : " << obj.int8_ms << " ms"
+                      << ", speedup : " << obj.get_speedup() << "x )";
+        }
+    };
+
+    /**
+     * Runs both paths over the same input and reports the accuracy / throughput trade off.
+     * Both timings cover the whole path from float input to float output.
+     */
+    template<typename FloatPath, typename Int8Path>
+    auto compare(FloatPath&& float_path, Int8Path&& int8_path, const Matrix& input,
+                 const std::size_t repetitions = 10) -> QuantizationReport {
+        using clock = std::chrono::steady_clock;
+        const auto time_ms = [repetitions, &input](auto&& fn) {
+            const auto start = clock::now();
+            for (std::size_t i = 0; i < repetitions; ++i) {
+                fn(input);
+            }
+            return std::chrono::duration<double, std::milli>(clock::now() - start).count() / static_cast<double>(repetitions);
+        };
+
+        const Matrix expected = float_path(input);
+        const Matrix actual = int8_path(input);
+
+        QuantizationReport report;
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            const double delta = std::abs(static_cast<double>(expected.data()[i]) - actual.data()[i]);
+            report.max_abs_error = std::max(report.max_abs_error, delta);
+            report.mean_abs_error += delta;
+        }
+        report.mean_abs_error /= static_cast<double>(std::max<std::size_t>(expected.size(), 1));
+
+        report.float_ms = time_ms(float_path);
+        report.int8_ms = time_ms(int8_path);
+        return report;
+    }
+}
+#endif //QUANTIZATION_HPP
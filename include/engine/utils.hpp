@@ -63,7 +63,11 @@ namespace PlexiStruct::Utils {
         Engine::ScalarValue<T> to;
 
         auto operator<(const Edge& edge) const -> bool {
-            return from < edge.from;
+            // Ordering on the ids of both ends, a value feeding several consumers has one edge per consumer
+            constexpr typename Engine::ScalarValue<T>::IdLess less;
+            if (less(from, edge.from)) return true;
+            if (less(edge.from, from)) return false;
+            return less(to, edge.to);
         }
 
         friend std::ostream & operator<<(std::ostream &os, const Edge &obj) {
@@ -74,9 +78,12 @@ namespace PlexiStruct::Utils {
         }
     };
 
+    template<typename T>
+    using NodeSet = std::set<Engine::ScalarValue<T>, typename Engine::ScalarValue<T>::IdLess>;
+
     template<typename T>
     struct TraceObj {
-        std::set<Engine::ScalarValue<T>> nodes;
+        NodeSet<T> nodes;
         std::set<Edge<T>> edges;
 
     };
@@ -85,7 +92,7 @@ namespace PlexiStruct::Utils {
     class TraceBuilder {
 
         Engine::ScalarValue<T> root_;
-        std::set<Engine::ScalarValue<T>> nodes_;
+        NodeSet<T> nodes_;
         std::set<Edge<T>> edges_;
 
     public:
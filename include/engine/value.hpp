@@ -6,6 +6,8 @@
 #define VALUE_HPP
 #include <ostream>
 #include <bits/stdc++.h>
+
+#include "precision.hpp"
 namespace PlexiStruct::Engine {
 
     enum class Operations: std::uint8_t {
@@ -24,11 +26,15 @@ namespace PlexiStruct::Engine {
         return os << "";
     };
 
+    /**
+     * Every constructed value gets a fresh id, copies share it. IdLess, KeyHasher and KeyEqual
+     * go through the id, so two nodes holding the same number stay distinct in a trace.
+     */
     template<typename T = float>
     class ScalarValue {
     public:
-        explicit ScalarValue(const T& value, const std::set<ScalarValue>& children = {}, const Operations op = Operations::NO_OPERATION)
-        : value_(value), previous_(children), op_(op) {}
+        explicit ScalarValue(const T& value, const std::vector<ScalarValue>& children = {}, const Operations op = Operations::NO_OPERATION)
+        : id_(next_id()), value_(value), previous_(children), op_(op) {}
 
         friend std::ostream & operator<<(std::ostream &os, const ScalarValue &obj) {
              os     << "ScalerValue( Value : " << obj.value_
@@ -39,15 +45,33 @@ namespace PlexiStruct::Engine {
             return os;
         }
 
-        auto get_children() const -> std::set<ScalarValue> {
+        /**
+         * Operands in the order the operation consumed them, (lhs, rhs) for binary operations
+         */
+        auto get_children() const -> std::vector<ScalarValue> {
             return previous_;
         }
 
+        [[nodiscard]]
+        auto get_id() const -> std::size_t {
+            return id_;
+        }
+
         [[nodiscard]]
         auto get_operations() const -> Operations {
             return op_;
         }
 
+        [[nodiscard]]
+        auto get_value() const -> T {
+            return value_;
+        }
+
+        [[nodiscard]]
+        auto get_grad() const -> T {
+            return grad_;
+        }
+
         auto operator <(const ScalarValue& other) const -> bool {
             return value_ < other.value_;
         }
@@ -57,15 +81,22 @@ namespace PlexiStruct::Engine {
         }
 
         auto operator+(const ScalarValue<T>& other) -> ScalarValue<T> {
-            std::set<ScalarValue> children = {*this, other};
-            return ScalarValue(value_ + other.value_, children, Operations::ADD);
+            return ScalarValue(value_ + other.value_, {*this, other}, Operations::ADD);
         }
 
         auto operator-(const ScalarValue<T>& other) -> ScalarValue<T> {
-            std::set<ScalarValue> children = {*this, other};
-            return ScalarValue(value_ - other.value_, children, Operations::SUBTRACT);
+            return ScalarValue(value_ - other.value_, {*this, other}, Operations::SUBTRACT);
         }
 
+        /**
+         * Node identity ordering for sets and maps of graph nodes
+         */
+        struct IdLess {
+            auto operator()(const ScalarValue& lhs, const ScalarValue& rhs) const -> bool {
+                return lhs.id_ < rhs.id_;
+            }
+        };
+
         struct KeyHasher {
             /**
              * This function is used to calculate the keys of scalar values
@@ -73,33 +104,29 @@ namespace PlexiStruct::Engine {
              * @return
              */
             auto operator()(const ScalarValue& key) const -> std::size_t {
-                const std::size_t h1 = std::hash<T>()(key.value_);
-                std::size_t h2 { 0 };
-                if (key.get_children().size() > 0) {
-                    const auto& children = key.get_children();
-                    h2 = std::accumulate(std::begin(children), std::end(children), std::size_t{0},
-                        [](const std::size_t& lhs, const ScalarValue& rhs) {
-                            auto h_inner = std::hash<T>()(rhs.value_);
-                            return lhs + h_inner;
-                        });
-                }
-
-                return h1 ^ (h2 << 1);
+                return std::hash<std::size_t>()(key.id_);
             }
         };
 
         struct KeyEqual {
             auto operator()(const ScalarValue& lhs, const ScalarValue& rhs) const -> bool {
-                return lhs.value_ == rhs.value_;
+                return lhs.id_ == rhs.id_;
             }
         };
 
 
     protected:
+        std::size_t id_;
         T value_;
         T grad_ { 0 };
-        std::set<ScalarValue> previous_;
+        std::vector<ScalarValue> previous_;
         Operations op_;
+
+    private:
+        static auto next_id() -> std::size_t {
+            static std::atomic<std::size_t> counter { 0 };
+            return counter.fetch_add(1, std::memory_order_relaxed);
+        }
     };
 }
 #endif //VALUE_HPP
@@ -0,0 +1,172 @@
+#ifndef CONCURRENT_GRAPH_BUILDER_HPP
+#define CONCURRENT_GRAPH_BUILDER_HPP
+#include <bits/stdc++.h>
+
+#include "functional_utils.hpp"
+#include "parallel.hpp"
+
+namespace PlexiStruct::graph {
+
+    /**
+     * Result of a concurrent build: vertex i is vertices[i], edges are in CSR form
+     */
+    template<typename T>
+    struct BuiltGraph {
+        std::vector<T> vertices;
+        CSR csr;
+
+        auto to_graph() const -> Graph<T, Edge> {
+            Graph<T, Edge> result(vertices);
+            for (std::size_t u = 0; u < csr.get_vertex_count(); ++u) {
+                for (const auto v: csr.neighbours_of(u)) {
+                    result.add_edge(Edge::of(u, v));
+                }
+            }
+            return result;
+        }
+    };
+
+    /**
+     * Graph ingestion from many threads at once. Vertex ids come from a map split into
+     * SHARDS independently locked shards, so threads only contend when they hit the same
+     * shard. Edges never take a lock: every thread appends to the buffer of its own
+     * Inserter. build() scatters the buffers into CSR with a parallel counting sort.
+     */
+    template<typename T, typename Hash = std::hash<T>>
+    class ConcurrentGraphBuilder {
+        static constexpr std::size_t SHARDS = 64;
+
+        struct alignas(64) Shard {
+            std::mutex mutex;
+            std::unordered_map<T, std::size_t, Hash> ids;
+            std::vector<std::pair<std::size_t, T>> vertices;
+        };
+
+        using EdgeBuffer = std::vector<std::pair<std::size_t, std::size_t>>;
+
+        std::array<Shard, SHARDS> shards_ {};
+        std::atomic<std::size_t> next_id_ { 0 };
+        std::mutex buffers_mutex_;
+        std::deque<EdgeBuffer> buffers_; // deque keeps handed out buffers in place
+
+        auto shard_of(const T& vertex) -> Shard& {
+            // Mix the hash so that identity hashes of small integers still spread over shards
+            const std::size_t h = Hash()(vertex) * 0x9E3779B97F4A7C15ull;
+            return shards_[(h >> 32) % SHARDS];
+        }
+
+    public:
+        /**
+         * Per thread handle, must not be shared between threads
+         */
+        class Inserter {
+            ConcurrentGraphBuilder* owner_;
+            EdgeBuffer* edges_;
+        public:
+            explicit Inserter(ConcurrentGraphBuilder* owner, EdgeBuffer* edges): owner_(owner), edges_(edges) {}
+
+            auto add_vertex(const T& vertex) -> std::size_t {
+                return owner_->add_vertex(vertex);
+            }
+
+            /**
+             * Edge between ids returned by add_vertex, checked in build()
+             */
+            auto add_edge_ids(const std::size_t from, const std::size_t to) -> void {
+                edges_->emplace_back(from, to);
+            }
+
+            auto add_edge(const T& from, const T& to) -> void {
+                add_edge_ids(add_vertex(from), add_vertex(to));
+            }
+        };
+
+        ConcurrentGraphBuilder() = default;
+        ConcurrentGraphBuilder(const ConcurrentGraphBuilder&) = delete;
+        auto operator=(const ConcurrentGraphBuilder&) -> ConcurrentGraphBuilder& = delete;
+
+        auto inserter() -> Inserter {
+            const std::scoped_lock lock(buffers_mutex_);
+            return Inserter(this, &buffers_.emplace_back());
+        }
+
+        /**
+         * Thread safe, returns the existing id when the vertex was already added
+         */
+        auto add_vertex(const T& vertex) -> std::size_t {
+            Shard& shard = shard_of(vertex);
+            const std::scoped_lock lock(shard.mutex);
+            const auto [it, inserted] = shard.ids.try_emplace(vertex, 0);
+            if (inserted) {
+                it->second = next_id_.fetch_add(1, std::memory_order_relaxed);
+                shard.vertices.emplace_back(it->second, vertex);
+            }
+            return it->second;
+        }
+
+        [[nodiscard]]
+        auto get_vertex_count() const -> std::size_t {
+            return next_id_.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Must only be called once every inserting thread has finished. Rows of the CSR are
+         * sorted, so the output only depends on the ids that were handed out. Throws
+         * std::out_of_range when an edge names an id that add_vertex never returned.
+         */
+        auto build(const std::size_t threads = parallel::hardware_threads()) -> BuiltGraph<T> {
+            const std::size_t n = get_vertex_count();
+            BuiltGraph<T> result;
+
+            result.vertices.resize(n);
+            parallel::parallel_for(SHARDS, [&](const std::size_t begin, const std::size_t end, std::size_t) {
+                for (std::size_t s = begin; s < end; ++s) {
+                    for (const auto& [id, vertex]: shards_[s].vertices) {
+                        result.vertices[id] = vertex;
+                    }
+                }
+            }, threads, 1);
+
+            std::vector<std::atomic<std::size_t>> cursor(n);
+            std::atomic<bool> invalid { false };
+            parallel::parallel_for(buffers_.size(), [&](const std::size_t begin, const std::size_t end, std::size_t) {
+                for (std::size_t b = begin; b < end; ++b) {
+                    for (const auto& [from, to]: buffers_[b]) {
+                        if (from >= n || to >= n) {
+                            invalid.store(true, std::memory_order_relaxed);
+                            continue;
+                        }
+                        cursor[from].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }, threads, 1);
+            if (invalid.load(std::memory_order_relaxed)) {
+                throw std::out_of_range("ConcurrentGraphBuilder: edge refers to a vertex id that was never added");
+            }
+
+            CSR& csr = result.csr;
+            csr.offsets.assign(n + 1, 0);
+            for (std::size_t v = 0; v < n; ++v) {
+                csr.offsets[v + 1] = csr.offsets[v] + cursor[v].load(std::memory_order_relaxed);
+                cursor[v].store(csr.offsets[v], std::memory_order_relaxed);
+            }
+
+            csr.targets.resize(csr.offsets[n]);
+            parallel::parallel_for(buffers_.size(), [&](const std::size_t begin, const std::size_t end, std::size_t) {
+                for (std::size_t b = begin; b < end; ++b) {
+                    for (const auto& [from, to]: buffers_[b]) {
+                        csr.targets[cursor[from].fetch_add(1, std::memory_order_relaxed)] = to;
+                    }
+                }
+            }, threads, 1);
+
+            parallel::parallel_for(n, [&](const std::size_t begin, const std::size_t end, std::size_t) {
+                for (std::size_t v = begin; v < end; ++v) {
+                    std::sort(csr.targets.begin() + csr.offsets[v], csr.targets.begin() + csr.offsets[v + 1]);
+                }
+            }, threads);
+            return result;
+        }
+    };
+}
+#endif //CONCURRENT_GRAPH_BUILDER_HPP
@@ -294,11 +294,37 @@ namespace PlexiStruct::graph {
             return Edge(u, v);
         }
 
+        [[nodiscard]]
+        auto get_u() const -> std::size_t { return u_; }
+
+        [[nodiscard]]
+        auto get_v() const -> std::size_t { return v_; }
+
         bool operator==(const Edge & rhs) const {
             return u_ == rhs.u_ && v_ == rhs.v_;
         }
     };
 
+    /**
+     * Compressed sparse row adjacency: the targets of vertex u are
+     * targets[offsets[u] .. offsets[u + 1])
+     */
+    struct CSR {
+        std::vector<std::size_t> offsets { 0 };
+        std::vector<std::size_t> targets;
+
+        [[nodiscard]]
+        auto get_vertex_count() const -> std::size_t { return offsets.size() - 1; }
+
+        [[nodiscard]]
+        auto get_edges_count() const -> std::size_t { return targets.size(); }
+
+        [[nodiscard]]
+        auto neighbours_of(const std::size_t& index) const -> std::span<const std::size_t> {
+            return std::span(targets).subspan(offsets[index], offsets[index + 1] - offsets[index]);
+        }
+    };
+
     template<typename T>
     concept HasEqualityOperator = std::equality_comparable<T>;
 
@@ -332,6 +358,17 @@ namespace PlexiStruct::graph {
             return get_vertex_count() - 1;
         }
 
+        /**
+         * Both endpoints must be existing vertex indices, otherwise std::out_of_range
+         */
+        auto add_edge(const E& edge) -> void {
+            if (edge.get_v() >= get_vertex_count()) {
+                throw std::out_of_range("Graph::add_edge: target " + std::to_string(edge.get_v())
+                                        + " is not a vertex, vertex count is " + std::to_string(get_vertex_count()));
+            }
+            edges_.at(edge.get_u()).push_back(edge);
+        }
+
         auto vertex_of(const std::size_t& index) -> T {
             return vertices_.at(index);
         }
@@ -345,7 +382,7 @@ namespace PlexiStruct::graph {
 
         auto neighbours_of(const std::size_t& index) -> std::vector<T> {
             auto neighbouring_vertices = edges_.at(index)
-                                            | std::views::transform([this](E edge){return vertex_of(edge.v);});
+                                            | std::views::transform([this](E edge){return vertex_of(edge.get_v());});
             std::vector<T> result{};
             std::ranges::copy(neighbouring_vertices, std::back_inserter(result));
             return result;
@@ -362,6 +399,19 @@ namespace PlexiStruct::graph {
         auto edges_of(const T& vertex) -> std::vector<E> {
             return edges_of(index_of(vertex));
         }
+
+        auto to_csr() const -> CSR {
+            CSR result;
+            result.offsets.reserve(edges_.size() + 1);
+            result.targets.reserve(get_edges_count());
+            for (const auto& edges: edges_) {
+                for (const auto& edge: edges) {
+                    result.targets.push_back(edge.get_v());
+                }
+                result.offsets.push_back(result.targets.size());
+            }
+            return result;
+        }
     };
 
     namespace search {
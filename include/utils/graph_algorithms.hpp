@@ -0,0 +1,439 @@
+#ifndef GRAPH_ALGORITHMS_HPP
+#define GRAPH_ALGORITHMS_HPP
+#include <bits/stdc++.h>
+
+#include "functional_utils.hpp"
+#include "parallel.hpp"
+
+namespace PlexiStruct::graph::analytics {
+
+    using Labels = std::vector<std::size_t>;
+
+    /**
+     * Renames every label to the smallest vertex carrying it, so labelings produced by
+     * different algorithms can be compared directly
+     */
+    inline auto normalize_labels(const Labels& labels) -> Labels {
+        std::unordered_map<std::size_t, std::size_t> smallest;
+        for (std::size_t v = 0; v < labels.size(); ++v) {
+            smallest.try_emplace(labels[v], v);
+        }
+        Labels result(labels.size());
+        for (std::size_t v = 0; v < labels.size(); ++v) {
+            result[v] = smallest.at(labels[v]);
+        }
+        return result;
+    }
+
+    inline auto is_topological_order(const CSR& graph, const std::vector<std::size_t>& order) -> bool {
+        if (order.size() != graph.get_vertex_count()) {
+            return false;
+        }
+        std::vector<std::size_t> position(order.size(), std::numeric_limits<std::size_t>::max());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            if (order[i] >= order.size() || position[order[i]] != std::numeric_limits<std::size_t>::max()) {
+                return false;
+            }
+            position[order[i]] = i;
+        }
+        for (std::size_t u = 0; u < graph.get_vertex_count(); ++u) {
+            for (const auto v: graph.neighbours_of(u)) {
+                if (position[u] >= position[v]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Reversed graph, built with a parallel counting sort on the targets
+     */
+    inline auto transpose(const CSR& graph, const std::size_t requested_threads = parallel::hardware_threads()) -> CSR {
+        const std::size_t threads = parallel::clamp_threads(requested_threads);
+        const std::size_t n = graph.get_vertex_count();
+        std::vector<std::atomic<std::size_t>> counts(n);
+        parallel::parallel_for(graph.get_edges_count(), [&](const std::size_t begin, const std::size_t end, std::size_t) {
+            for (std::size_t e = begin; e < end; ++e) {
+                counts[graph.targets[e]].fetch_add(1, std::memory_order_relaxed);
+            }
+        }, threads);
+
+        CSR result;
+        result.offsets.assign(n + 1, 0);
+        for (std::size_t v = 0; v < n; ++v) {
+            result.offsets[v + 1] = result.offsets[v] + counts[v].load(std::memory_order_relaxed);
+            counts[v].store(result.offsets[v], std::memory_order_relaxed);
+        }
+        result.targets.resize(graph.get_edges_count());
+        parallel::parallel_for(n, [&](const std::size_t begin, const std::size_t end, std::size_t) {
+            for (std::size_t u = begin; u < end; ++u) {
+                for (const auto v: graph.neighbours_of(u)) {
+                    result.targets[counts[v].fetch_add(1, std::memory_order_relaxed)] = u;
+                }
+            }
+        }, threads);
+        // Sources land in arbitrary order inside each row, sort for deterministic output
+        parallel::parallel_for(n, [&](const std::size_t begin, const std::size_t end, std::size_t) {
+            for (std::size_t v = begin; v < end; ++v) {
+                std::sort(result.targets.begin() + result.offsets[v], result.targets.begin() + result.offsets[v + 1]);
+            }
+        }, threads);
+        return result;
+    }
+
+    namespace serial {
+        /**
+         * Kahn's algorithm, nullopt when the graph has a cycle
+         */
+        inline auto topological_sort(const CSR& graph) -> std::optional<std::vector<std::size_t>> {
+            const std::size_t n = graph.get_vertex_count();
+            std::vector<std::size_t> in_degree(n, 0);
+            for (const auto v: graph.targets) {
+                in_degree[v] += 1;
+            }
+            std::vector<std::size_t> order;
+            order.reserve(n);
+            for (std::size_t v = 0; v < n; ++v) {
+                if (in_degree[v] == 0) {
+                    order.push_back(v);
+                }
+            }
+            for (std::size_t head = 0; head < order.size(); ++head) {
+                for (const auto v: graph.neighbours_of(order[head])) {
+                    if (--in_degree[v] == 0) {
+                        order.push_back(v);
+                    }
+                }
+            }
+            if (order.size() != n) {
+                return std::nullopt;
+            }
+            return order;
+        }
+
+        /**
+         * Weakly connected components with union find, labelled by their smallest vertex
+         */
+        inline auto connected_components(const CSR& graph) -> Labels {
+            Labels parent(graph.get_vertex_count());
+            std::iota(parent.begin(), parent.end(), std::size_t{ 0 });
+            const auto find = [&parent](std::size_t v) {
+                while (parent[v] != v) {
+                    parent[v] = parent[parent[v]];
+                    v = parent[v];
+                }
+                return v;
+            };
+            for (std::size_t u = 0; u < graph.get_vertex_count(); ++u) {
+                for (const auto v: graph.neighbours_of(u)) {
+                    const std::size_t a = find(u), b = find(v);
+                    parent[std::max(a, b)] = std::min(a, b);
+                }
+            }
+            for (std::size_t v = 0; v < parent.size(); ++v) {
+                parent[v] = find(v);
+            }
+            return parent;
+        }
+
+        /**
+         * Tarjan's algorithm with an explicit call stack, labelled by the smallest vertex
+         */
+        inline auto strongly_connected_components(const CSR& graph) -> Labels {
+            constexpr auto UNVISITED = std::numeric_limits<std::size_t>::max();
+            const std::size_t n = graph.get_vertex_count();
+            std::vector<std::size_t> index(n, UNVISITED), low_link(n, 0);
+            std::vector<bool> on_stack(n, false);
+            std::vector<std::size_t> stack;
+            std::vector<std::pair<std::size_t, std::size_t>> calls; // (vertex, next edge)
+            Labels labels(n, 0);
+            std::size_t counter = 0;
+
+            for (std::size_t start = 0; start < n; ++start) {
+                if (index[start] != UNVISITED) {
+                    continue;
+                }
+                calls.emplace_back(start, graph.offsets[start]);
+                index[start] = low_link[start] = counter++;
+                stack.push_back(start);
+                on_stack[start] = true;
+
+                while (!calls.empty()) {
+                    auto& [u, edge] = calls.back();
+                    if (edge < graph.offsets[u + 1]) {
+                        const std::size_t v = graph.targets[edge++];
+                        if (index[v] == UNVISITED) {
+                            index[v] = low_link[v] = counter++;
+                            stack.push_back(v);
+                            on_stack[v] = true;
+                            calls.emplace_back(v, graph.offsets[v]);
+                        } else if (on_stack[v]) {
+                            low_link[u] = std::min(low_link[u], index[v]);
+                        }
+                        continue;
+                    }
+                    const std::size_t finished = u;
+                    calls.pop_back();
+                    if (!calls.empty()) {
+                        const std::size_t caller = calls.back().first;
+                        low_link[caller] = std::min(low_link[caller], low_link[finished]);
+                    }
+                    if (low_link[finished] == index[finished]) {
+                        std::vector<std::size_t> members;
+                        std::size_t w;
+                        do {
+                            w = stack.back();
+                            stack.pop_back();
+                            on_stack[w] = false;
+                            members.push_back(w);
+                        } while (w != finished);
+                        const std::size_t label = *std::ranges::min_element(members);
+                        for (const auto member: members) {
+                            labels[member] = label;
+                        }
+                    }
+                }
+            }
+            return labels;
+        }
+    }
+
+    /**
+     * Level synchronous Kahn: the current frontier is split across threads, in-degrees are
+     * decremented atomically and whoever drops a vertex to zero owns it in the next frontier.
+     * The order is a valid topological order but not necessarily serial::topological_sort's.
+     */
+    inline auto topological_sort(const CSR& graph, const std::size_t requested_threads = parallel::hardware_threads())
+        -> std::optional<std::vector<std::size_t>> {
+        const std::size_t threads = parallel::clamp_threads(requested_threads);
+        const std::size_t n = graph.get_vertex_count();
+        std::vector<std::atomic<std::size_t>> in_degree(n);
+        parallel::parallel_for(graph.get_edges_count(), [&](const std::size_t begin, const std::size_t end, std::size_t) {
+            for (std::size_t e = begin; e < end; ++e) {
+                in_degree[graph.targets[e]].fetch_add(1, std::memory_order_relaxed);
+            }
+        }, threads);
+
+        std::vector<std::vector<std::size_t>> local(threads);
+        parallel::parallel_for(n, [&](const std::size_t begin, const std::size_t end, const std::size_t worker) {
+            for (std::size_t v = begin; v < end; ++v) {
+                if (in_degree[v].load(std::memory_order_relaxed) == 0) {
+                    local[worker].push_back(v);
+                }
+            }
+        }, threads);
+
+        std::vector<std::size_t> order;
+        order.reserve(n);
+        std::vector<std::size_t> frontier = parallel::flatten(local);
+        while (!frontier.empty()) {
+            order.insert(order.end(), frontier.begin(), frontier.end());
+            for (auto& buffer: local) {
+                buffer.clear();
+            }
+            parallel::parallel_for(frontier.size(), [&](const std::size_t begin, const std::size_t end, const std::size_t worker) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    for (const auto v: graph.neighbours_of(frontier[i])) {
+                        if (in_degree[v].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                            local[worker].push_back(v);
+                        }
+                    }
+                }
+            }, threads, 256);
+            frontier = parallel::flatten(local);
+        }
+        if (order.size() != n) {
+            return std::nullopt;
+        }
+        return order;
+    }
+
+    /**
+     * Weakly connected components with a lock free union find (Shiloach-Vishkin style
+     * hooking): roots are only ever hooked under a smaller root with a CAS, so the final
+     * root of every component is its smallest vertex and no relabelling is needed.
+     */
+    inline auto connected_components(const CSR& graph, const std::size_t requested_threads = parallel::hardware_threads()) -> Labels {
+        const std::size_t threads = parallel::clamp_threads(requested_threads);
+        const std::size_t n = graph.get_vertex_count();
+        std::vector<std::atomic<std::size_t>> parent(n);
+        parallel::parallel_for(n, [&](const std::size_t begin, const std::size_t end, std::size_t) {
+            for (std::size_t v = begin; v < end; ++v) {
+                parent[v].store(v, std::memory_order_relaxed);
+            }
+        }, threads);
+
+        const auto find = [&parent](std::size_t v) {
+            while (true) {
+                std::size_t p = parent[v].load(std::memory_order_acquire);
+                if (p == v) {
+                    return v;
+                }
+                const std::size_t grand = parent[p].load(std::memory_order_acquire);
+                if (grand != p) {
+                    parent[v].compare_exchange_weak(p, grand, std::memory_order_acq_rel); // path halving
+                }
+                v = grand;
+            }
+        };
+
+        parallel::parallel_for(n, [&](const std::size_t begin, const std::size_t end, std::size_t) {
+            for (std::size_t u = begin; u < end; ++u) {
+                for (const auto v: graph.neighbours_of(u)) {
+                    std::size_t a = find(u), b = find(v);
+                    while (a != b) {
+                        if (a < b) {
+                            std::swap(a, b);
+                        }
+                        std::size_t expected = a;
+                        if (parent[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel)) {
+                            break;
+                        }
+                        a = find(a);
+                        b = find(b);
+                    }
+                }
+            }
+        }, threads);
+
+        Labels labels(n);
+        parallel::parallel_for(n, [&](const std::size_t begin, const std::size_t end, std::size_t) {
+            for (std::size_t v = begin; v < end; ++v) {
+                labels[v] = find(v);
+            }
+        }, threads);
+        return labels;
+    }
+
+    /**
+     * Strongly connected components by colouring. Every round each remaining vertex starts
+     * with its own id as colour and the largest colour is pushed forward along edges until
+     * nothing changes; a vertex whose colour equals its id is the largest vertex reaching
+     * its colour class, and its SCC is what reaches it backward inside that class. Both
+     * propagations are frontier based and run in parallel; the found SCCs are removed and
+     * the next round works on what is left. Each round starts by trimming vertices that
+     * have no remaining predecessor or successor, which peels off trees cheaply.
+     */
+    inline auto strongly_connected_components(const CSR& graph, const std::size_t requested_threads = parallel::hardware_threads()) -> Labels {
+        const std::size_t threads = parallel::clamp_threads(requested_threads);
+        constexpr auto UNASSIGNED = std::numeric_limits<std::size_t>::max();
+        const std::size_t n = graph.get_vertex_count();
+        const CSR reversed = transpose(graph, threads);
+
+        std::vector<std::atomic<std::size_t>> colour(n);
+        std::vector<std::atomic<std::size_t>> component(n);
+        std::vector<std::atomic<bool>> queued(n);
+        std::vector<std::vector<std::size_t>> local(threads);
+        for (std::size_t v = 0; v < n; ++v) {
+            component[v].store(UNASSIGNED, std::memory_order_relaxed);
+        }
+
+        std::vector<std::size_t> remaining(n);
+        std::iota(remaining.begin(), remaining.end(), std::size_t{ 0 });
+
+        const auto clear_local = [&local] {
+            for (auto& buffer: local) {
+                buffer.clear();
+            }
+        };
+
+        const auto keep_unassigned = [&] {
+            clear_local();
+            parallel::parallel_for(remaining.size(), [&](const std::size_t begin, const std::size_t end, const std::size_t worker) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    if (component[remaining[i]].load(std::memory_order_relaxed) == UNASSIGNED) {
+                        local[worker].push_back(remaining[i]);
+                    }
+                }
+            }, threads);
+            remaining = parallel::flatten(local);
+        };
+
+        while (!remaining.empty()) {
+            // Trim: a vertex without remaining predecessors or successors is an SCC on its own
+            parallel::parallel_for(remaining.size(), [&](const std::size_t begin, const std::size_t end, std::size_t) {
+                const auto has_remaining = [&](const std::span<const std::size_t> neighbours, const std::size_t self) {
+                    return std::ranges::any_of(neighbours, [&](const std::size_t w) {
+                        return w != self && component[w].load(std::memory_order_relaxed) == UNASSIGNED;
+                    });
+                };
+                for (std::size_t i = begin; i < end; ++i) {
+                    const std::size_t v = remaining[i];
+                    if (!has_remaining(graph.neighbours_of(v), v) || !has_remaining(reversed.neighbours_of(v), v)) {
+                        component[v].store(v, std::memory_order_relaxed);
+                    }
+                }
+            }, threads);
+            keep_unassigned();
+
+            parallel::parallel_for(remaining.size(), [&](const std::size_t begin, const std::size_t end, std::size_t) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    colour[remaining[i]].store(remaining[i], std::memory_order_relaxed);
+                    queued[remaining[i]].store(false, std::memory_order_relaxed);
+                }
+            }, threads);
+
+            // Forward: push the largest colour to every vertex it reaches
+            std::vector<std::size_t> frontier = remaining;
+            while (!frontier.empty()) {
+                clear_local();
+                parallel::parallel_for(frontier.size(), [&](const std::size_t begin, const std::size_t end, const std::size_t worker) {
+                    for (std::size_t i = begin; i < end; ++i) {
+                        const std::size_t u = frontier[i];
+                        // Clearing the flag before reading the colour means a concurrent raise
+                        // is either seen here or re-queues u for the next round
+                        queued[u].store(false);
+                        const std::size_t c = colour[u].load();
+                        for (const auto v: graph.neighbours_of(u)) {
+                            if (component[v].load(std::memory_order_relaxed) == UNASSIGNED
+                                && parallel::atomic_fetch_max(colour[v], c)
+                                && !queued[v].exchange(true)) {
+                                local[worker].push_back(v);
+                            }
+                        }
+                    }
+                }, threads, 256);
+                frontier = parallel::flatten(local);
+            }
+
+            // Backward: from every root, walk reversed edges that stay inside its colour
+            clear_local();
+            parallel::parallel_for(remaining.size(), [&](const std::size_t begin, const std::size_t end, const std::size_t worker) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    const std::size_t v = remaining[i];
+                    if (colour[v].load(std::memory_order_relaxed) == v) {
+                        component[v].store(v, std::memory_order_relaxed);
+                        local[worker].push_back(v);
+                    }
+                }
+            }, threads);
+            frontier = parallel::flatten(local);
+            while (!frontier.empty()) {
+                clear_local();
+                parallel::parallel_for(frontier.size(), [&](const std::size_t begin, const std::size_t end, const std::size_t worker) {
+                    for (std::size_t i = begin; i < end; ++i) {
+                        const std::size_t v = frontier[i];
+                        const std::size_t c = colour[v].load(std::memory_order_relaxed);
+                        for (const auto w: reversed.neighbours_of(v)) {
+                            std::size_t expected = UNASSIGNED;
+                            if (colour[w].load(std::memory_order_relaxed) == c
+                                && component[w].compare_exchange_strong(expected, c, std::memory_order_relaxed)) {
+                                local[worker].push_back(w);
+                            }
+                        }
+                    }
+                }, threads, 256);
+                frontier = parallel::flatten(local);
+            }
+            keep_unassigned();
+        }
+
+        Labels labels(n);
+        for (std::size_t v = 0; v < n; ++v) {
+            labels[v] = component[v].load(std::memory_order_relaxed);
+        }
+        return normalize_labels(labels);
+    }
+}
+#endif //GRAPH_ALGORITHMS_HPP
@@ -0,0 +1,200 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+#include <bits/stdc++.h>
+
+namespace PlexiStruct::parallel {
+
+    constexpr std::size_t DEFAULT_GRAIN = 4096;
+
+    inline auto hardware_threads() -> std::size_t {
+        return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    /**
+     * Thread counts of 0 mean "no extra threads", every entry point clamps once with this
+     */
+    inline auto clamp_threads(const std::size_t threads) -> std::size_t {
+        return std::max<std::size_t>(threads, 1);
+    }
+
+    /**
+     * Persistent workers, started lazily and reused across calls. run(workers, task) calls
+     * task(w) for every w < workers: the caller takes w = 0, pool threads the rest. One run
+     * executes at a time; a run started from inside a task executes serially on that thread.
+     */
+    class ThreadPool {
+        std::mutex dispatch_mutex_; // serialises callers
+        std::mutex mutex_;
+        std::condition_variable start_;
+        std::condition_variable done_;
+        std::vector<std::jthread> threads_;
+        void (*invoke_)(void*, std::size_t) { nullptr };
+        void* task_ { nullptr };
+        std::size_t participants_ { 0 };
+        std::size_t pending_ { 0 };
+        std::size_t generation_ { 0 };
+        std::exception_ptr error_;
+        bool stopping_ { false };
+
+        static auto inside_task() -> bool& {
+            thread_local bool inside = false;
+            return inside;
+        }
+
+        auto work(const std::size_t index) -> void {
+            inside_task() = true;
+            std::size_t seen = 0;
+            std::unique_lock lock(mutex_);
+            while (true) {
+                start_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+                if (stopping_) {
+                    return;
+                }
+                seen = generation_;
+                if (index >= participants_) {
+                    continue;
+                }
+                lock.unlock();
+                try {
+                    invoke_(task_, index);
+                } catch (...) {
+                    const std::scoped_lock error_lock(mutex_);
+                    if (!error_) {
+                        error_ = std::current_exception();
+                    }
+                }
+                lock.lock();
+                if (--pending_ == 0) {
+                    done_.notify_one();
+                }
+            }
+        }
+
+    public:
+        ThreadPool() = default;
+        ThreadPool(const ThreadPool&) = delete;
+        auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+
+        ~ThreadPool() {
+            {
+                const std::scoped_lock lock(mutex_);
+                stopping_ = true;
+            }
+            start_.notify_all();
+        }
+
+        template<typename F>
+        auto run(const std::size_t workers, F&& task) -> void {
+            if (workers <= 1 || inside_task()) {
+                for (std::size_t w = 0; w < workers; ++w) {
+                    task(w);
+                }
+                return;
+            }
+            const std::scoped_lock dispatch(dispatch_mutex_);
+            while (threads_.size() + 1 < workers) {
+                threads_.emplace_back([this, index = threads_.size() + 1] { work(index); });
+            }
+            {
+                const std::scoped_lock lock(mutex_);
+                invoke_ = [](void* context, const std::size_t w) { (*static_cast<std::remove_reference_t<F>*>(context))(w); };
+                task_ = static_cast<void*>(std::addressof(task));
+                participants_ = workers;
+                pending_ = workers - 1;
+                error_ = nullptr;
+                ++generation_;
+            }
+            start_.notify_all();
+
+            std::exception_ptr caller_error;
+            inside_task() = true;
+            try {
+                task(std::size_t{ 0 });
+            } catch (...) {
+                caller_error = std::current_exception();
+            }
+            inside_task() = false;
+
+            std::unique_lock lock(mutex_);
+            done_.wait(lock, [&] { return pending_ == 0; });
+            if (caller_error) {
+                std::rethrow_exception(caller_error);
+            }
+            if (error_) {
+                std::rethrow_exception(error_);
+            }
+        }
+    };
+
+    inline auto default_pool() -> ThreadPool& {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    /**
+     * Splits [0, count) into one contiguous chunk per worker and calls body(begin, end, worker)
+     * on the workers of default_pool(). Ranges smaller than `grain` run on the calling thread,
+     * worker ids are always < threads.
+     */
+    template<typename F>
+    auto parallel_for(const std::size_t count, F&& body, const std::size_t threads = hardware_threads(),
+                      const std::size_t grain = DEFAULT_GRAIN) -> void {
+        const std::size_t workers = std::clamp<std::size_t>((count + grain - 1) / std::max<std::size_t>(grain, 1), 1, clamp_threads(threads));
+        if (workers == 1) {
+            body(std::size_t{ 0 }, count, std::size_t{ 0 });
+            return;
+        }
+        const std::size_t chunk = (count + workers - 1) / workers;
+        default_pool().run(workers, [&](const std::size_t w) {
+            const std::size_t begin = std::min(count, w * chunk);
+            body(begin, std::min(count, begin + chunk), w);
+        });
+    }
+
+    /**
+     * Lowers target to value, returns true when this call changed it. Sequentially consistent
+     * so callers can publish "value changed" flags right after it.
+     */
+    template<typename T>
+    auto atomic_fetch_min(std::atomic<T>& target, const T value) -> bool {
+        T current = target.load();
+        while (value < current) {
+            if (target.compare_exchange_weak(current, value)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Raises target to value, returns true when this call changed it
+     */
+    template<typename T>
+    auto atomic_fetch_max(std::atomic<T>& target, const T value) -> bool {
+        T current = target.load();
+        while (value > current) {
+            if (target.compare_exchange_weak(current, value)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Concatenates per worker buffers into one vector
+     */
+    template<typename T>
+    auto flatten(const std::vector<std::vector<T>>& buffers) -> std::vector<T> {
+        std::vector<T> result;
+        std::size_t total = 0;
+        for (const auto& buffer: buffers) {
+            total += buffer.size();
+        }
+        result.reserve(total);
+        for (const auto& buffer: buffers) {
+            result.insert(result.end(), buffer.begin(), buffer.end());
+        }
+        return result;
+    }
+}
+#endif //PARALLEL_HPP
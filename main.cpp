@@ -1,8 +1,78 @@
 #include <iostream>
 
 #include "include/utils/functional_utils.hpp"
+#include "include/utils/graph_algorithms.hpp"
+#include "include/utils/concurrent_graph_builder.hpp"
 #include "include/engine/value.hpp"
 #include "include/engine/utils.hpp"
+#include "include/engine/quantization.hpp"
+#include "include/engine/fusion.hpp"
+#include "include/engine/memory_planner.hpp"
+#include "include/engine/expression.hpp"
+
+/**
+ * Every heap allocation of the process goes through here, benchmarks read the counter
+ * around a region to see how many allocations it really made. Kept out of line, GCC
+ * flags malloc/free as mismatched with new/delete once they are inlined into callers.
+ */
+static std::atomic<std::size_t> allocation_count { 0 };
+
+[[gnu::noinline]] auto operator new(const std::size_t size) -> void* {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] auto operator delete(void* pointer) noexcept -> void {
+    std::free(pointer);
+}
+
+[[gnu::noinline]] auto operator delete(void* pointer, std::size_t) noexcept -> void {
+    std::free(pointer);
+}
+
+/**
+ * Heap allocations made by one call to fn
+ */
+template<typename F>
+auto count_allocations(F&& fn) -> std::size_t {
+    const std::size_t before = allocation_count.load(std::memory_order_relaxed);
+    fn();
+    return allocation_count.load(std::memory_order_relaxed) - before;
+}
+
+/**
+ * Average wall time of `runs` calls to fn in milliseconds, together with the last result
+ */
+template<typename F>
+auto time_ms(F&& fn, const int runs = 1) {
+    const auto start = std::chrono::steady_clock::now();
+    auto value = fn();
+    for (int i = 1; i < runs; ++i) {
+        value = fn();
+    }
+    return std::pair{std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / runs, value};
+}
+
+/**
+ * Tensor scale stand in for a lowered graph: every leaf broadcast to `elements` copies of its traced value
+ */
+template<typename T>
+auto broadcast_leaves(const PlexiStruct::Engine::fusion::Graph<T>& graph, const std::size_t elements) -> std::vector<std::vector<T>> {
+    std::vector<std::vector<T>> result;
+    for (const auto leaf: graph.get_leaves()) {
+        result.emplace_back(elements, graph.nodes[leaf].value);
+    }
+    return result;
+}
+
+template<typename T>
+auto as_spans(const std::vector<std::vector<T>>& buffers) -> std::vector<std::span<const T>> {
+    return {buffers.begin(), buffers.end()};
+}
+
 auto test_inital_value( ) -> void {
     using namespace PlexiStruct;
     Engine::Operations op = Engine::Operations::DIVIDE;
@@ -62,8 +132,342 @@ auto test_graph_viz_hello_world() -> void {
     Utils::hello_world_graphs();
 }
 
+auto test_quantization() -> void {
+    using namespace PlexiStruct::Engine;
+    constexpr std::size_t batch = 64;
+    const std::vector<std::size_t> features { 256, 256, 128 };
+    std::mt19937 rng(42);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    const auto random_matrix = [&](const std::size_t rows, const std::size_t cols, const float scale = 1.0f) {
+        quant::Matrix m = quant::Matrix::from_shape({rows, cols});
+        std::generate_n(m.data(), m.size(), [&] { return scale * dist(rng); });
+        return m;
+    };
+
+    std::vector<quant::Matrix> weights;
+    std::vector<std::vector<float>> biases;
+    for (std::size_t l = 0; l + 1 < features.size(); ++l) {
+        weights.push_back(random_matrix(features[l + 1], features[l], 1.0f / std::sqrt(static_cast<float>(features[l]))));
+        biases.emplace_back(features[l + 1], 0.1f);
+    }
+
+    std::vector<quant::Matrix> samples;
+    for (int i = 0; i < 8; ++i) {
+        samples.push_back(random_matrix(batch, features.front()));
+    }
+    const auto network = quant::QuantizedMLP::calibrate(weights, biases, samples);
+
+    const auto report = quant::compare(
+        [&](const quant::Matrix& x) { return quant::QuantizedMLP::reference(weights, biases, x); },
+        [&](const quant::Matrix& x) { return network.forward(x); },
+        random_matrix(batch, features.front()));
+    std::cout << report << std::endl;
+}
+
+auto test_reduced_precision() -> void {
+    using namespace PlexiStruct::Engine;
+    auto x = ScalarValue<bfloat16>(bfloat16(1.5f));
+    auto y = ScalarValue<bfloat16>(bfloat16(0.25f));
+    std::cout << x + y << std::endl;
+
+    constexpr std::size_t count = 1 << 24;
+    std::vector<float> source(count);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::ranges::generate(source, [&] { return dist(rng); });
+
+    const auto bench = [&]<typename T>(const std::string& name) {
+        using clock = std::chrono::steady_clock;
+        std::vector<T> x_buffer(count), y_buffer(count);
+        kernels::to_storage<T>(source, x_buffer);
+        kernels::to_storage<T>(source, y_buffer);
+
+        auto start = clock::now();
+        const auto total = kernels::sum<T>(x_buffer);
+        const double sum_s = std::chrono::duration<double>(clock::now() - start).count();
+
+        start = clock::now();
+        kernels::axpy<T>(0.5f, x_buffer, y_buffer);
+        const double axpy_s = std::chrono::duration<double>(clock::now() - start).count();
+
+        const double gigabytes = static_cast<double>(count * sizeof(T)) / 1e9;
+        std::cout << name << " ( " << sizeof(T) << " bytes ) sum : " << total
+                  << " | sum " << gigabytes / sum_s << " GB/s"
+                  << " | axpy " << 3 * gigabytes / axpy_s << " GB/s" << std::endl;
+    };
+    bench.operator()<float>("float");
+    bench.operator()<float16>("fp16");
+    bench.operator()<bfloat16>("bf16");
+
+    // A gradient far below the fp16 subnormal range survives scaling and lands in fp32
+    DynamicLossScaler scaler;
+    const std::array scaled_grads { float16(scaler.scale(1e-8f)), float16(scaler.scale(0.001f)) };
+    std::array<float, 2> master_grads {};
+    const bool step_ok = scaler.unscale(std::span<const float16>(scaled_grads), std::span(master_grads));
+    std::cout << "loss scaling | step ok : " << step_ok << " | master grads : " << master_grads[0] << ", " << master_grads[1]
+              << " | unscaled in fp16 would be : " << float16(1e-8f) << std::endl;
+}
+
+auto test_fusion() -> void {
+    using namespace PlexiStruct;
+    {
+        // Equal valued nodes and non commutative operands must survive lowering
+        auto x = Engine::ScalarValue(1.0), y = Engine::ScalarValue(2.0), z = Engine::ScalarValue(2.0);
+        auto p = Engine::ScalarValue(1.0), q = Engine::ScalarValue(2.0), r = Engine::ScalarValue(3.0);
+        auto nested = x + (y - z);
+        auto chained = (p + q) + r;
+        auto reversed = (y - z) - x;
+        for (const auto& value: {nested, chained, reversed}) {
+            std::cout << "traced : " << value.get_value()
+                      << " | lowered : " << Engine::fusion::lower(Utils::TraceBuilder<double>::of(value).get_trace()).evaluate() << std::endl;
+        }
+    }
+
+    auto a = Engine::ScalarValue(1.5);
+    auto b = Engine::ScalarValue(2.25);
+    auto c = Engine::ScalarValue(4.125);
+    auto d = Engine::ScalarValue(8.0625);
+    auto e = Engine::ScalarValue(16.03125);
+    auto result = a + (b - c) + (d - e);
 
-int main() {
-    PlexiStruct::functional::test_evaluation();
+    const auto trace = Utils::TraceBuilder<double>::of(result).get_trace();
+    const auto graph = Engine::fusion::lower(trace);
+
+    constexpr std::size_t elements = 1 << 22;
+    const auto [fused, report] = Engine::fusion::fuse(graph, elements);
+    std::cout << report << std::endl;
+    std::cout << "traced : " << result.get_value()
+              << " | lowered : " << graph.evaluate()
+              << " | fused : " << fused.evaluate() << std::endl;
+
+    const auto leaf_data = broadcast_leaves(graph, elements);
+    const auto leaves = as_spans(leaf_data);
+    const auto [unfused_ms, unfused_buffers] = time_ms([&] { return Engine::fusion::forward(graph, leaves, elements); });
+    const auto [fused_ms, fused_buffers] = time_ms([&] { return Engine::fusion::forward(fused, leaves, elements); });
+    std::cout << "forward unfused : " << unfused_ms << " ms | fused : " << fused_ms << " ms"
+              << " | outputs match : " << (unfused_buffers.back() == fused_buffers.back()) << std::endl;
+
+    const std::vector<double> seed(elements, 1.0);
+    const auto unfused_grads = Engine::fusion::backward(graph, unfused_buffers, std::span<const double>(seed));
+    const auto fused_grads = Engine::fusion::backward(fused, fused_buffers, std::span<const double>(seed));
+    const auto unfused_leaves = graph.get_leaves();
+    const auto fused_leaves = fused.get_leaves();
+    for (std::size_t i = 0; i < unfused_leaves.size(); ++i) {
+        std::cout << "d/d(" << graph.nodes[unfused_leaves[i]].value << ") unfused : " << unfused_grads[unfused_leaves[i]].front()
+                  << " | fused : " << fused_grads[fused_leaves[i]].front() << std::endl;
+    }
+}
+
+auto test_memory_planner() -> void {
+    using namespace PlexiStruct;
+    // x_{i + 1} = x_i + (x_i - c_i): every x_i has two consumers so it stays materialised
+    auto x = Engine::ScalarValue(1.0);
+    for (int i = 0; i < 16; ++i) {
+        auto c = Engine::ScalarValue(0.3 + 0.0137 * i);
+        auto difference = x - c;
+        x = x + difference;
+    }
+    constexpr std::size_t elements = 1 << 20;
+    constexpr int runs = 20;
+    const auto trace = Utils::TraceBuilder<double>::of(x).get_trace();
+    const auto [graph, fusion_report] = Engine::fusion::fuse(Engine::fusion::lower(trace), elements);
+    std::cout << fusion_report << std::endl;
+
+    const auto leaf_data = broadcast_leaves(graph, elements);
+    const auto leaves = as_spans(leaf_data);
+
+    Engine::memory::PlannedExecutor<double> executor(graph, elements);
+    std::span<const double> planned;
+    const std::size_t warmup_allocations = count_allocations([&] { planned = executor.run(leaves); });
+    const std::size_t steady_allocations = count_allocations([&] { planned = executor.run(leaves); });
+    const std::size_t naive_allocations = count_allocations([&] { return Engine::fusion::forward(graph, leaves, elements); });
+    const auto naive = Engine::fusion::forward(graph, leaves, elements);
+    std::cout << "traced : " << x.get_value() << " | naive : " << naive.back().front()
+              << " | planned : " << planned.front()
+              << " | outputs match : " << std::ranges::equal(planned, naive.back()) << std::endl;
+
+    const double naive_ms = time_ms([&] { return Engine::fusion::forward(graph, leaves, elements); }, runs).first;
+    const double planned_ms = time_ms([&] { return executor.run(leaves); }, runs).first;
+    std::cout << executor.get_report() << std::endl;
+    std::cout << "naive : " << naive_ms << " ms ( " << naive_allocations << " allocations per run )"
+              << " | planned : " << planned_ms << " ms ( " << warmup_allocations << " allocations warm-up, "
+              << steady_allocations << " per run after )" << std::endl;
+}
+
+auto test_graph_analytics() -> void {
+    using namespace PlexiStruct::graph;
+    constexpr std::size_t vertex_count = 200000, edge_count = 800000;
+    const std::size_t threads = std::max<std::size_t>(4, PlexiStruct::parallel::hardware_threads());
+    std::mt19937_64 rng(3);
+    std::uniform_int_distribution<std::size_t> pick(0, vertex_count - 1);
+
+    std::vector<int> vertices(vertex_count);
+    std::iota(vertices.begin(), vertices.end(), 0);
+    std::vector<std::size_t> rank(vertex_count);
+    std::iota(rank.begin(), rank.end(), std::size_t{ 0 });
+    std::ranges::shuffle(rank, rng);
+
+    Graph<int, Edge> dag(vertices);
+    Graph<int, Edge> cyclic(vertices);
+    for (std::size_t e = 0; e < edge_count; ++e) {
+        const std::size_t a = pick(rng), b = pick(rng);
+        const std::size_t u = std::min(a, b), v = std::max(a, b);
+        if (u != v) {
+            dag.add_edge(Edge::of(rank[u], rank[v]));
+        }
+        cyclic.add_edge(Edge::of(pick(rng), pick(rng)));
+    }
+    const CSR dag_csr = dag.to_csr();
+    const CSR cyclic_csr = cyclic.to_csr();
+
+    const auto [serial_topo_ms, serial_order] = time_ms([&] { return analytics::serial::topological_sort(dag_csr); });
+    const auto [topo_ms, order] = time_ms([&] { return analytics::topological_sort(dag_csr, threads); });
+    std::cout << "topological sort serial : " << serial_topo_ms << " ms | parallel : " << topo_ms << " ms"
+              << " | valid : " << (order && analytics::is_topological_order(dag_csr, *order))
+              << " | cycle detected : " << !analytics::topological_sort(cyclic_csr, threads).has_value() << std::endl;
+
+    const auto [serial_cc_ms, serial_cc] = time_ms([&] { return analytics::serial::connected_components(cyclic_csr); });
+    const auto [cc_ms, cc] = time_ms([&] { return analytics::connected_components(cyclic_csr, threads); });
+    std::cout << "connected components serial : " << serial_cc_ms << " ms | parallel : " << cc_ms << " ms"
+              << " | match : " << (serial_cc == cc) << std::endl;
+
+    const auto [serial_scc_ms, serial_scc] = time_ms([&] { return analytics::serial::strongly_connected_components(cyclic_csr); });
+    const auto [scc_ms, scc] = time_ms([&] { return analytics::strongly_connected_components(cyclic_csr, threads); });
+    std::cout << "strongly connected components serial : " << serial_scc_ms << " ms | parallel : " << scc_ms << " ms"
+              << " | components : " << std::set(scc.begin(), scc.end()).size()
+              << " | match : " << (serial_scc == scc) << std::endl;
+}
+
+auto test_expression_templates() -> void {
+    using namespace PlexiStruct::Engine;
+    constexpr auto x = expr::var<0>();
+    constexpr auto y = expr::var<1>();
+    constexpr auto z = expr::var<2>();
+    constexpr auto w = expr::var<3>();
+    constexpr auto formula = (x + (y - z)) - (w - x) + (y + w);
+
+    static_assert(expr::evaluate(formula, std::array{1.0, 2.0, 3.0, 4.0}) == 3.0);
+    constexpr auto derivative = expr::value_and_grad(x * y / (z - 1.0), std::array{1.0, 2.0, 3.0});
+    static_assert(derivative.grad[0] == 1.0 && derivative.grad[1] == 0.5 && derivative.grad[2] == -0.5);
+
+    constexpr int iterations = 100000;
+
+    const auto [dynamic_ms, dynamic_sum] = time_ms([] {
+        double sum = 0;
+        for (int i = 0; i < iterations; ++i) {
+            auto a = ScalarValue(1.0 * i), b = ScalarValue(2.0), c = ScalarValue(3.0 * i), d = ScalarValue(4.0);
+            sum += ((a + (b - c)) - (d - a) + (b + d)).get_value();
+        }
+        return sum;
+    });
+    const auto [static_ms, static_sum] = time_ms([&] {
+        double sum = 0;
+        for (int i = 0; i < iterations; ++i) {
+            sum += expr::evaluate(formula, std::array{1.0 * i, 2.0, 3.0 * i, 4.0});
+        }
+        return sum;
+    });
+    const auto [grad_ms, grad_sum] = time_ms([&] {
+        double sum = 0;
+        for (int i = 0; i < iterations; ++i) {
+            const auto result = expr::value_and_grad(formula, std::array{1.0 * i, 2.0, 3.0 * i, 4.0});
+            sum += result.value + result.grad[0];
+        }
+        return sum;
+    });
+    std::cout << "dynamic graph : " << dynamic_ms << " ms | expression template : " << static_ms << " ms"
+              << " | with gradient : " << grad_ms << " ms | speedup : " << dynamic_ms / static_ms << "x"
+              << " | results match : " << (dynamic_sum == static_sum) << std::endl;
+    std::cout << "checksum with gradient : " << grad_sum << std::endl;
+
+    // Same formula on the dynamic graph: ScalarValue leaves in, a traceable ScalarValue out
+    const std::array leaves {ScalarValue(1.0), ScalarValue(2.0), ScalarValue(3.0), ScalarValue(4.0)};
+    const auto dynamic = expr::to_scalar_value(formula, leaves);
+    const auto lowered = fusion::lower(PlexiStruct::Utils::TraceBuilder<double>::of(dynamic).get_trace());
+    std::cout << "bridge | static : " << expr::evaluate(formula, leaves)
+              << " | dynamic : " << dynamic.get_value()
+              << " | lowered : " << lowered.evaluate()
+              << " | d/dx : " << expr::value_and_grad(formula, leaves).grad[0] << std::endl;
+}
+
+auto test_concurrent_graph_builder() -> void {
+    using namespace PlexiStruct::graph;
+    constexpr std::size_t edge_count = 2000000;
+    std::mt19937_64 rng(11);
+    std::uniform_int_distribution<long> pick(0, 500000);
+    std::vector<std::pair<long, long>> edges(edge_count);
+    std::ranges::generate(edges, [&] { return std::pair{pick(rng), pick(rng)}; });
+    auto expected = edges;
+    std::ranges::sort(expected);
+
+    for (const std::size_t threads: {1, 2, 4, 8}) {
+        const auto start = std::chrono::steady_clock::now();
+        ConcurrentGraphBuilder<long> builder;
+        {
+            std::vector<std::jthread> workers;
+            for (std::size_t t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t, inserter = builder.inserter()]() mutable {
+                    for (std::size_t e = t; e < edges.size(); e += threads) {
+                        inserter.add_edge(edges[e].first, edges[e].second);
+                    }
+                });
+            }
+        }
+        const auto ingested = std::chrono::steady_clock::now();
+        const BuiltGraph<long> graph = builder.build(threads);
+        const auto built = std::chrono::steady_clock::now();
+
+        std::vector<std::pair<long, long>> actual;
+        actual.reserve(edge_count);
+        for (std::size_t u = 0; u < graph.csr.get_vertex_count(); ++u) {
+            for (const auto v: graph.csr.neighbours_of(u)) {
+                actual.emplace_back(graph.vertices[u], graph.vertices[v]);
+            }
+        }
+        std::ranges::sort(actual);
+
+        const double ingest_s = std::chrono::duration<double>(ingested - start).count();
+        const double build_s = std::chrono::duration<double>(built - ingested).count();
+        std::cout << threads << " threads | vertices : " << graph.vertices.size()
+                  << " | ingest : " << ingest_s * 1e3 << " ms ( " << edge_count / ingest_s / 1e6 << " M edges/s )"
+                  << " | csr : " << build_s * 1e3 << " ms"
+                  << " | edges match : " << (actual == expected) << std::endl;
+    }
+}
+
+/**
+ * Without arguments runs the evaluation demo, otherwise the named benchmark or "all" of them
+ */
+int main(const int argc, char** argv) {
+    const std::vector<std::pair<std::string, std::function<void()>>> benchmarks {
+        {"quantization", test_quantization},
+        {"reduced_precision", test_reduced_precision},
+        {"fusion", test_fusion},
+        {"memory_planner", test_memory_planner},
+        {"graph_analytics", test_graph_analytics},
+        {"expression_templates", test_expression_templates},
+        {"concurrent_graph_builder", test_concurrent_graph_builder},
+    };
+    if (argc < 2) {
+        PlexiStruct::functional::test_evaluation();
+        return 0;
+    }
+    const std::string name = argv[1];
+    bool found = false;
+    for (const auto& [benchmark, run]: benchmarks) {
+        if (name == "all" || name == benchmark) {
+            std::cout << "== " << benchmark << std::endl;
+            run();
+            found = true;
+        }
+    }
+    if (!found) {
+        std::cerr << "usage : " << argv[0] << " [all";
+        for (const auto& benchmark: benchmarks | std::views::keys) {
+            std::cerr << " | " << benchmark;
+        }
+        std::cerr << "]" << std::endl;
+        return 1;
+    }
     return 0;
 }
\ No newline at end of file